@@ -0,0 +1,257 @@
+#include "LineScanner.h"
+
+#include <cstdint>
+
+#if HAVE_SSE2
+#include <immintrin.h>
+#endif
+
+namespace irc {
+
+/**
+ * @brief Scans with the fastest implementation the CPU supports.
+ *
+ * @param data The bytes to scan.
+ * @param length Amount of bytes to scan.
+ * @return Result The offset of the first line feed and what precedes it.
+ */
+LineScanner::Result LineScanner::scan(const char* data, unsigned long length) {
+    static const Implementation implementation = getImplementation();
+    return scan(data, length, implementation);
+}
+
+/**
+ * @brief Scans with the given implementation, which must be supported, for tests and benchmarks.
+ */
+LineScanner::Result LineScanner::scan(const char* data, unsigned long length, Implementation implementation) {
+    if (implementation == SCAN_AVX2) {
+        return scanAvx2_(data, length);
+    }
+    if (implementation == SCAN_SSE2) {
+        return scanSse2_(data, length);
+    }
+    return scanScalar_(data, length, 0, false, false);
+}
+
+LineScanner::Implementation LineScanner::getImplementation() {
+    if (isSupported(SCAN_AVX2)) {
+        return SCAN_AVX2;
+    }
+    if (isSupported(SCAN_SSE2)) {
+        return SCAN_SSE2;
+    }
+    return SCAN_SCALAR;
+}
+
+bool LineScanner::isSupported(Implementation implementation) {
+    if (implementation == SCAN_AVX2) {
+#if HAVE_AVX2_TARGET
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    if (implementation == SCAN_SSE2) {
+        return HAVE_SSE2;
+    }
+    return true;
+}
+
+const char* LineScanner::getImplementationName(Implementation implementation) {
+    if (implementation == SCAN_AVX2) {
+        return "avx2";
+    }
+    if (implementation == SCAN_SSE2) {
+        return "sse2";
+    }
+    return "scalar";
+}
+
+/**
+ * @brief Checks for well-formed UTF-8: no overlong encodings, surrogates or code points above U+10FFFF.
+ */
+bool LineScanner::isValidUtf8(const char* data, unsigned long length) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    unsigned long i = 0;
+    while (i < length) {
+        unsigned char byte = bytes[i];
+        if (byte < 0x80) {
+            i++;
+            continue;
+        }
+        unsigned long sequenceLength;
+        unsigned char min = 0x80;  // allowed range of the second byte
+        unsigned char max = 0xBF;
+        if (byte >= 0xC2 && byte <= 0xDF) {
+            sequenceLength = 2;
+        } else if (byte >= 0xE0 && byte <= 0xEF) {
+            sequenceLength = 3;
+            min = (byte == 0xE0) ? 0xA0 : 0x80;  // overlong
+            max = (byte == 0xED) ? 0x9F : 0xBF;  // surrogates
+        } else if (byte >= 0xF0 && byte <= 0xF4) {
+            sequenceLength = 4;
+            min = (byte == 0xF0) ? 0x90 : 0x80;  // overlong
+            max = (byte == 0xF4) ? 0x8F : 0xBF;  // above U+10FFFF
+        } else {
+            return false;
+        }
+        if (length - i < sequenceLength || bytes[i + 1] < min || bytes[i + 1] > max) {
+            return false;
+        }
+        for (unsigned long j = 2; j < sequenceLength; j++) {
+            if (bytes[i + j] < 0x80 || bytes[i + j] > 0xBF) {
+                return false;
+            }
+        }
+        i += sequenceLength;
+    }
+    return true;
+}
+
+/**
+ * @brief Scans one byte at a time from start, also finishes the tail of the vectorized scans.
+ */
+LineScanner::Result LineScanner::scanScalar_(const char* data, unsigned long length, unsigned long start, bool containsNul,
+                                             bool containsNonAscii) {
+    unsigned long i = start;
+    for (; i < length; i++) {
+        unsigned char byte = static_cast<unsigned char>(data[i]);
+        if (byte == '\n') {
+            break;
+        }
+        containsNul = containsNul || byte == '\0';
+        containsNonAscii = containsNonAscii || byte > 0x7F;
+    }
+    return Result{i, containsNul, containsNonAscii};
+}
+
+#if HAVE_SSE2
+
+/**
+ * @brief Scans from i 16 bytes at a time, with the masks cut at the first line feed. The last
+ * block overlaps the one before it instead of reading past the data, only data shorter than
+ * 16 bytes is scanned one byte at a time. Inlined into both vectorized scans, so the AVX2 one stays in
+ * VEX encoded instructions and never pays for a switch to legacy SSE code.
+ */
+static inline __attribute__((always_inline)) LineScanner::Result finishScan(const char* data, unsigned long length, unsigned long i,
+                                                                            bool containsNul, bool containsNonAscii) {
+    const __m128i lineFeeds = _mm_set1_epi8('\n');
+    const __m128i zeros = _mm_setzero_si128();
+    uint32_t nulMasks = containsNul ? 1 : 0;
+    uint32_t nonAsciiMasks = containsNonAscii ? 1 : 0;
+    while (i < length && length >= 16) {
+        // the last block is loaded so that it ends with the data, the bytes before i are shifted out
+        unsigned long blockStart = (i + 16 <= length) ? i : length - 16;
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + blockStart));
+        unsigned long skipped = i - blockStart;
+        uint32_t lineFeedMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, lineFeeds))) >> skipped;
+        uint32_t nulMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zeros))) >> skipped;
+        uint32_t nonAsciiMask = static_cast<uint32_t>(_mm_movemask_epi8(chunk)) >> skipped;
+        i = blockStart + 16;
+        if (lineFeedMask != 0) {
+            uint32_t before = (lineFeedMask & (0u - lineFeedMask)) - 1;
+            nulMasks |= nulMask & before;
+            nonAsciiMasks |= nonAsciiMask & before;
+            return LineScanner::Result{blockStart + skipped + static_cast<unsigned long>(__builtin_ctz(lineFeedMask)), nulMasks != 0,
+                                       nonAsciiMasks != 0};
+        }
+        nulMasks |= nulMask;
+        nonAsciiMasks |= nonAsciiMask;
+    }
+    for (; i < length && data[i] != '\n'; i++) {
+        nulMasks |= (data[i] == '\0') ? 1 : 0;
+        nonAsciiMasks |= (static_cast<unsigned char>(data[i]) > 0x7F) ? 1 : 0;
+    }
+    return LineScanner::Result{i, nulMasks != 0, nonAsciiMasks != 0};
+}
+
+/**
+ * @brief Compares 32 bytes per iteration as two 16 byte vectors.
+ *
+ * Only the line feed comparison is tested on every iteration. The NULs are tracked as the unsigned
+ * minimum of all bytes and the bytes above 0x7F as the OR of all bytes (their sign bit), both are
+ * looked at once at the end. Only the block holding the first line feed gets all three masks,
+ * cut at the line feed. The rest, shorter than a block, is handed to finishScan().
+ */
+LineScanner::Result LineScanner::scanSse2_(const char* data, unsigned long length) {
+    const __m128i lineFeeds = _mm_set1_epi8('\n');
+    const __m128i zeros = _mm_setzero_si128();
+    __m128i minimumAccumulator = _mm_set1_epi8(-1);
+    __m128i byteAccumulator = zeros;
+    unsigned long i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+        __m128i lineFeedLow = _mm_cmpeq_epi8(low, lineFeeds);
+        __m128i lineFeedHigh = _mm_cmpeq_epi8(high, lineFeeds);
+        if (_mm_movemask_epi8(_mm_or_si128(lineFeedLow, lineFeedHigh)) != 0) {
+            uint32_t lineFeedMask =
+                static_cast<uint32_t>(_mm_movemask_epi8(lineFeedLow)) | static_cast<uint32_t>(_mm_movemask_epi8(lineFeedHigh)) << 16;
+            uint32_t nulMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, zeros))) |
+                               static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, zeros))) << 16;
+            uint32_t nonAsciiMask = static_cast<uint32_t>(_mm_movemask_epi8(low)) | static_cast<uint32_t>(_mm_movemask_epi8(high)) << 16;
+            uint32_t before = (lineFeedMask & (0u - lineFeedMask)) - 1;
+            return Result{i + static_cast<unsigned long>(__builtin_ctz(lineFeedMask)),
+                          (nulMask & before) != 0 || _mm_movemask_epi8(_mm_cmpeq_epi8(minimumAccumulator, zeros)) != 0,
+                          (nonAsciiMask & before) != 0 || _mm_movemask_epi8(byteAccumulator) != 0};
+        }
+        minimumAccumulator = _mm_min_epu8(minimumAccumulator, _mm_min_epu8(low, high));
+        byteAccumulator = _mm_or_si128(byteAccumulator, _mm_or_si128(low, high));
+    }
+    return finishScan(data, length, i, _mm_movemask_epi8(_mm_cmpeq_epi8(minimumAccumulator, zeros)) != 0,
+                      _mm_movemask_epi8(byteAccumulator) != 0);
+}
+
+#else
+
+LineScanner::Result LineScanner::scanSse2_(const char* data, unsigned long length) {
+    return scanScalar_(data, length, 0, false, false);
+}
+
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2_TARGET
+
+static inline uint64_t mask64(int low, int high) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(low)) | static_cast<uint64_t>(static_cast<uint32_t>(high)) << 32;
+}
+
+/**
+ * @brief Same as scanSse2_() with two 32 byte vectors per iteration, only called when the CPU supports AVX2.
+ */
+__attribute__((target("avx2"))) LineScanner::Result LineScanner::scanAvx2_(const char* data, unsigned long length) {
+    const __m256i lineFeeds = _mm256_set1_epi8('\n');
+    const __m256i zeros = _mm256_setzero_si256();
+    __m256i minimumAccumulator = _mm256_set1_epi8(-1);
+    __m256i byteAccumulator = zeros;
+    unsigned long i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i lineFeedLow = _mm256_cmpeq_epi8(low, lineFeeds);
+        __m256i lineFeedHigh = _mm256_cmpeq_epi8(high, lineFeeds);
+        if (_mm256_movemask_epi8(_mm256_or_si256(lineFeedLow, lineFeedHigh)) != 0) {
+            uint64_t lineFeedMask = mask64(_mm256_movemask_epi8(lineFeedLow), _mm256_movemask_epi8(lineFeedHigh));
+            uint64_t nulMask = mask64(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zeros)), _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, zeros)));
+            uint64_t nonAsciiMask = mask64(_mm256_movemask_epi8(low), _mm256_movemask_epi8(high));
+            uint64_t before = (lineFeedMask & (0ull - lineFeedMask)) - 1;
+            return Result{i + static_cast<unsigned long>(__builtin_ctzll(lineFeedMask)),
+                          (nulMask & before) != 0 || _mm256_movemask_epi8(_mm256_cmpeq_epi8(minimumAccumulator, zeros)) != 0,
+                          (nonAsciiMask & before) != 0 || _mm256_movemask_epi8(byteAccumulator) != 0};
+        }
+        minimumAccumulator = _mm256_min_epu8(minimumAccumulator, _mm256_min_epu8(low, high));
+        byteAccumulator = _mm256_or_si256(byteAccumulator, _mm256_or_si256(low, high));
+    }
+    return finishScan(data, length, i, _mm256_movemask_epi8(_mm256_cmpeq_epi8(minimumAccumulator, zeros)) != 0,
+                      _mm256_movemask_epi8(byteAccumulator) != 0);
+}
+
+#else
+
+LineScanner::Result LineScanner::scanAvx2_(const char* data, unsigned long length) {
+    return scanSse2_(data, length);
+}
+
+#endif  // HAVE_AVX2_TARGET
+
+}  // namespace irc
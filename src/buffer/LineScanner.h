@@ -0,0 +1,45 @@
+#ifndef LINESCANNER_H
+#define LINESCANNER_H
+
+#include "../common/os.h"
+
+namespace irc {
+
+/**
+ * @class LineScanner
+ * @brief Finds the next line feed and checks the bytes before it in the same pass.
+ *
+ * The bytes are compared 32 (AVX2) or 16 (SSE2) at a time when the CPU has the instructions,
+ * otherwise one at a time. The AVX2 code is compiled for that target only and picked at run
+ * time, so the binary still runs on any x86-64.
+ *
+ * Besides the position of the line feed a scan tells whether a NUL byte (not allowed in a
+ * message) or a byte above 0x7F precedes it. Pure ASCII is valid UTF-8, so isValidUtf8() only
+ * has to be run on the rare lines that contain other bytes, if a caller cares at all.
+ */
+class LineScanner {
+   public:
+    enum Implementation { SCAN_SCALAR, SCAN_SSE2, SCAN_AVX2 };
+
+    struct Result {
+        unsigned long lineFeed;  // offset of the first '\n', the scanned length if there is none
+        bool containsNul;        // a NUL byte precedes lineFeed
+        bool containsNonAscii;   // a byte above 0x7F precedes lineFeed
+    };
+
+    static Result scan(const char* data, unsigned long length);
+    static Result scan(const char* data, unsigned long length, Implementation implementation);
+    static Implementation getImplementation();
+    static bool isSupported(Implementation implementation);
+    static const char* getImplementationName(Implementation implementation);
+    static bool isValidUtf8(const char* data, unsigned long length);
+
+   private:
+    static Result scanScalar_(const char* data, unsigned long length, unsigned long start, bool containsNul, bool containsNonAscii);
+    static Result scanSse2_(const char* data, unsigned long length);
+    static Result scanAvx2_(const char* data, unsigned long length);
+};
+
+}  // namespace irc
+
+#endif
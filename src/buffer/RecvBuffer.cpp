@@ -0,0 +1,223 @@
+#include "RecvBuffer.h"
+
+namespace irc {
+
+RecvBuffer::RecvBuffer()
+    : capacity_(0), begin_(0), end_(0), scanned_(0), scannedNul_(false), scannedNonAscii_(false), isSkippingLine_(false) {}
+
+RecvBuffer::RecvBuffer(const RecvBuffer& other)
+    : capacity_(0), begin_(0), end_(0), scanned_(0), scannedNul_(false), scannedNonAscii_(false), isSkippingLine_(false) {
+    *this = other;
+}
+
+RecvBuffer& RecvBuffer::operator=(const RecvBuffer& other) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    if (other.empty() == false) {
+        std::memcpy(prepare(other.size()), other.data(), other.size());
+        commit(other.size());
+    }
+    isSkippingLine_ = other.isSkippingLine_;
+    return *this;
+}
+
+RecvBuffer::~RecvBuffer() {}
+
+/**
+ * @brief Makes sure at least minWritableSize bytes can be written after the data.
+ *
+ * The unread data is first moved to the front of the block if that frees enough space,
+ * a bigger block is allocated only when the data itself does not leave room.
+ * The returned memory is not initialized.
+ *
+ * @param minWritableSize Amount of bytes the caller wants to write.
+ * @return char* Where to write, valid until the next non-const call.
+ */
+char* RecvBuffer::prepare(unsigned long minWritableSize) {
+    if (capacity_ - end_ >= minWritableSize) {
+        return storage_.get() + end_;
+    }
+    unsigned long dataSize = size();
+    if (capacity_ - dataSize >= minWritableSize) {
+        std::memmove(storage_.get(), storage_.get() + begin_, dataSize);
+    } else {
+        unsigned long newCapacity = (capacity_ == 0) ? RECV_BUFFER_INITIAL_CAPACITY : capacity_ * 2;
+        while (newCapacity - dataSize < minWritableSize) {
+            newCapacity *= 2;
+        }
+        reallocate_(newCapacity);
+    }
+    begin_ = 0;
+    end_ = dataSize;
+    return storage_.get() + end_;
+}
+
+void RecvBuffer::reallocate_(unsigned long newCapacity) {
+    std::unique_ptr<char[]> newStorage(new char[newCapacity]);
+    if (size() > 0) {
+        std::memcpy(newStorage.get(), storage_.get() + begin_, size());
+    }
+    storage_.swap(newStorage);
+    capacity_ = newCapacity;
+}
+
+unsigned long RecvBuffer::getWritableSize() const {
+    return capacity_ - end_;
+}
+
+/**
+ * @brief Marks receivedSize bytes written after prepare() as data.
+ */
+void RecvBuffer::commit(unsigned long receivedSize) {
+    end_ += (receivedSize > getWritableSize()) ? getWritableSize() : receivedSize;
+}
+
+const char* RecvBuffer::data() const {
+    return storage_.get() + begin_;
+}
+
+unsigned long RecvBuffer::size() const {
+    return end_ - begin_;
+}
+
+bool RecvBuffer::empty() const {
+    return begin_ == end_;
+}
+
+/**
+ * @brief Drops consumedSize bytes from the front, without moving the remaining data.
+ * The next nextLine() scans the remaining data again, the dropped part may have set its flags.
+ */
+void RecvBuffer::consume(unsigned long consumedSize) {
+    if (consumedSize >= size()) {
+        clear();
+        return;
+    }
+    begin_ += consumedSize;
+    forgetScan_();
+}
+
+void RecvBuffer::append(const std::string& packet) {
+    if (packet.empty()) {
+        return;
+    }
+    std::memcpy(prepare(packet.size()), packet.data(), packet.size());
+    commit(packet.size());
+}
+
+/**
+ * @brief Frames the next CRLF terminated line and consumes it, including the CRLF.
+ *
+ * The search resumes where the previous unsuccessful call stopped, so a line
+ * arriving in many small packets is not rescanned from its start every time.
+ * A line feed without a carriage return before it is part of the line.
+ *
+ * A line without CRLF in its first MAX_MSG_LENGTH + 2 bytes is returned right away
+ * with isTooLong set and its first MAX_MSG_LENGTH bytes, the rest of it is skipped.
+ *
+ * @param line Set to the line without the CRLF, the bytes stay in place until the next prepare().
+ * @return true if a complete or overlong line was found, false if more data is needed.
+ */
+bool RecvBuffer::nextLine(Line& line) {
+    if (isSkippingLine_ && skipOverlongLine_() == false) {
+        return false;
+    }
+    const char* begin = data();
+    unsigned long available = size();
+    unsigned long searchable = (available > MAX_MSG_LENGTH + 2) ? MAX_MSG_LENGTH + 2 : available;
+    while (scanned_ < searchable) {
+        LineScanner::Result scan = LineScanner::scan(begin + scanned_, searchable - scanned_);
+        scannedNul_ = scannedNul_ || scan.containsNul;
+        scannedNonAscii_ = scannedNonAscii_ || scan.containsNonAscii;
+        unsigned long lineFeed = scanned_ + scan.lineFeed;
+        if (lineFeed == searchable) {
+            break;
+        }
+        if (lineFeed > 0 && begin[lineFeed - 1] == '\r') {
+            line.data = begin;
+            line.length = lineFeed - 1;
+            line.containsNul = scannedNul_;
+            line.containsNonAscii = scannedNonAscii_;
+            line.isTooLong = false;
+            forgetScan_();
+            begin_ += line.length + 2;
+            if (begin_ == end_) {
+                begin_ = 0;  // nothing left, reuse the block from the start without moving data
+                end_ = 0;
+            }
+            return true;
+        }
+        scanned_ = lineFeed + 1;
+    }
+    scanned_ = searchable;
+    if (searchable < MAX_MSG_LENGTH + 2) {
+        return false;
+    }
+    line.data = begin;
+    line.length = MAX_MSG_LENGTH;
+    line.containsNul = scannedNul_;
+    line.containsNonAscii = scannedNonAscii_;
+    line.isTooLong = true;
+    // A CRLF ending the line can start right after the bytes that were searched
+    consume(MAX_MSG_LENGTH + 1);
+    isSkippingLine_ = true;
+    return true;
+}
+
+/**
+ * @brief Drops the rest of an overlong line, up to and including its CRLF.
+ *
+ * Without a CRLF all received data is dropped, except a final carriage return
+ * that the line feed of the next packet may complete.
+ *
+ * @return true if the CRLF was found, false if the line goes on in the next packet.
+ */
+bool RecvBuffer::skipOverlongLine_() {
+    const char* begin = data();
+    unsigned long available = size();
+    unsigned long searched = 0;
+    while (searched < available) {
+        unsigned long lineFeed = searched + LineScanner::scan(begin + searched, available - searched).lineFeed;
+        if (lineFeed == available) {
+            break;
+        }
+        if (lineFeed > 0 && begin[lineFeed - 1] == '\r') {
+            consume(lineFeed + 1);
+            isSkippingLine_ = false;
+            return true;
+        }
+        searched = lineFeed + 1;
+    }
+    unsigned long kept = (available > 0 && begin[available - 1] == '\r') ? 1 : 0;
+    begin_ = end_ - kept;
+    if (kept == 0) {
+        begin_ = 0;
+        end_ = 0;
+    }
+    forgetScan_();
+    return false;
+}
+
+void RecvBuffer::clear() {
+    begin_ = 0;
+    end_ = 0;
+    forgetScan_();
+    isSkippingLine_ = false;
+}
+
+void RecvBuffer::forgetScan_() {
+    scanned_ = 0;
+    scannedNul_ = false;
+    scannedNonAscii_ = false;
+}
+
+std::string RecvBuffer::toString() const {
+    if (empty()) {
+        return std::string();
+    }
+    return std::string(data(), size());
+}
+
+}  // namespace irc
@@ -0,0 +1,79 @@
+#ifndef RECVBUFFER_H
+#define RECVBUFFER_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "../common/magicNumber.h"
+#include "LineScanner.h"
+
+namespace irc {
+
+/**
+ * @class RecvBuffer
+ * @brief Reusable receive buffer that the socket can be read into directly.
+ *
+ * Received bytes live between begin_ and end_ of a single heap block.
+ * Consuming a message only advances begin_, the remaining bytes are moved
+ * to the front lazily when prepare() runs out of tail space, so neither
+ * receiving nor consuming shifts the whole buffer on every call.
+ *
+ * Lines are framed with nextLine(), which remembers how far it has already
+ * searched for CRLF so every received byte is scanned only once. The same
+ * LineScanner pass also notes NUL and non-ASCII bytes, so the message parser
+ * does not have to look at the line again to reject it.
+ *
+ * A line is searched for at most MAX_MSG_LENGTH bytes. A longer one is reported
+ * with isTooLong set, and the rest of it is dropped as it arrives until its CRLF,
+ * so a client that never ends its line cannot make the buffer grow.
+ */
+class RecvBuffer {
+   public:
+    /**
+     * @brief A view of one line in the buffer, excluding the CRLF.
+     * Valid until the next call to prepare(), append() or clear().
+     */
+    struct Line {
+        const char* data;
+        unsigned long length;
+        bool containsNul;
+        bool containsNonAscii;  // only then the line can be invalid UTF-8, see LineScanner::isValidUtf8()
+        bool isTooLong;         // longer than MAX_MSG_LENGTH, only its first MAX_MSG_LENGTH bytes are in data
+    };
+
+    RecvBuffer();
+    RecvBuffer(const RecvBuffer& other);
+    RecvBuffer& operator=(const RecvBuffer& other);
+    ~RecvBuffer();
+
+    char* prepare(unsigned long minWritableSize);
+    unsigned long getWritableSize() const;
+    void commit(unsigned long receivedSize);
+
+    const char* data() const;
+    unsigned long size() const;
+    bool empty() const;
+    void consume(unsigned long consumedSize);
+    void append(const std::string& packet);
+    bool nextLine(Line& line);
+    void clear();
+    std::string toString() const;
+
+   private:
+    void reallocate_(unsigned long newCapacity);
+    void forgetScan_();
+    bool skipOverlongLine_();
+    std::unique_ptr<char[]> storage_;
+    unsigned long capacity_;
+    unsigned long begin_;
+    unsigned long end_;
+    unsigned long scanned_;  // amount of bytes after begin_ known to contain no CRLF
+    bool scannedNul_;        // the scanned bytes contain a NUL
+    bool scannedNonAscii_;   // the scanned bytes contain a byte above 0x7F
+    bool isSkippingLine_;    // the data up to the next CRLF is the rest of an overlong line
+};
+
+}  // namespace irc
+
+#endif
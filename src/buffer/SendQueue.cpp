@@ -0,0 +1,160 @@
+#include "SendQueue.h"
+
+namespace irc {
+
+SendQueue::SendQueue() : frontOffset_(0), size_(0) {}
+
+const std::string& SendQueue::Chunk::data() const {
+    return shared ? *shared : owned;
+}
+
+/**
+ * @brief The owned chunk that length more bytes go into: the last one while it has room, else a new one.
+ */
+std::string& SendQueue::ownedTail_(unsigned long length) {
+    if (chunks_.empty() || chunks_.back().shared || chunks_.back().owned.size() + length > SEND_QUEUE_CHUNK_SIZE) {
+        chunks_.push_back(Chunk());
+    }
+    return chunks_.back().owned;
+}
+
+/**
+ * @brief Queues a copy of packet behind the data that is already waiting.
+ */
+void SendQueue::append(const std::string& packet) {
+    if (packet.empty()) {
+        return;
+    }
+    ownedTail_(packet.size()) += packet;
+    size_ += packet.size();
+}
+
+/**
+ * @brief Writes the line reply describes straight into the queue, without building it elsewhere first.
+ */
+void SendQueue::append(const ReplyBuilder& reply) {
+    if (reply.size() == 0) {
+        return;
+    }
+    reply.appendTo(ownedTail_(reply.size()));
+    size_ += reply.size();
+}
+
+/**
+ * @brief Queues a reference to payload behind the data that is already waiting, without copying it.
+ */
+void SendQueue::append(const SharedPayload& payload) {
+    if (!payload || payload->empty()) {
+        return;
+    }
+    chunks_.push_back(Chunk());
+    chunks_.back().shared = payload;
+    size_ += payload->size();
+}
+
+/**
+ * @brief Describes the queued data, starting with the unsent part of the first chunk.
+ *
+ * @param iovecs Array of at least maxIovecs entries to fill.
+ * @param maxIovecs Upper bound for the amount of chunks handed to one writev()/sendmsg().
+ * @return int The amount of entries filled, 0 if the queue is empty.
+ */
+int SendQueue::gather(struct iovec* iovecs, int maxIovecs) const {
+    int count = 0;
+    for (std::deque<Chunk>::const_iterator it = chunks_.begin(); it != chunks_.end() && count < maxIovecs; it++) {
+        const std::string& data = it->data();
+        unsigned long offset = (it == chunks_.begin()) ? frontOffset_ : 0;
+        iovecs[count].iov_base = const_cast<char*>(data.data() + offset);
+        iovecs[count].iov_len = data.size() - offset;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Drops sentSize bytes from the front of the queue after a (partial) write.
+ */
+void SendQueue::consume(unsigned long sentSize) {
+    if (sentSize >= size_) {
+        clear();
+        return;
+    }
+    size_ -= sentSize;
+    while (sentSize > 0) {
+        unsigned long frontRemaining = chunks_.front().data().size() - frontOffset_;
+        if (sentSize < frontRemaining) {
+            frontOffset_ += sentSize;
+            return;
+        }
+        sentSize -= frontRemaining;
+        chunks_.pop_front();
+        frontOffset_ = 0;
+    }
+}
+
+/**
+ * @brief Moves the data of unsent in front of the data of this queue, leaving unsent empty.
+ *
+ * Used to put back what a write left over from a queue that was swapped out to be sent,
+ * ahead of the data that was queued in the meantime.
+ */
+void SendQueue::prepend(SendQueue& unsent) {
+    if (unsent.empty()) {
+        unsent.clear();
+        return;
+    }
+    if (empty() == false) {
+        if (frontOffset_ != 0) {
+            // Only the first chunk carries an offset, its sent part is dropped before moving it behind the other queue
+            Chunk& front = chunks_.front();
+            front.owned = front.data().substr(frontOffset_);
+            front.shared.reset();
+            frontOffset_ = 0;
+        }
+        for (Chunk& chunk : chunks_) {
+            unsent.chunks_.push_back(std::move(chunk));
+        }
+        unsent.size_ += size_;
+    }
+    swap(unsent);
+    unsent.clear();
+}
+
+void SendQueue::swap(SendQueue& other) {
+    chunks_.swap(other.chunks_);
+    std::swap(frontOffset_, other.frontOffset_);
+    std::swap(size_, other.size_);
+}
+
+unsigned long SendQueue::size() const {
+    return size_;
+}
+
+bool SendQueue::empty() const {
+    return size_ == 0;
+}
+
+unsigned long SendQueue::getChunkCount() const {
+    return chunks_.size();
+}
+
+void SendQueue::clear() {
+    chunks_.clear();
+    frontOffset_ = 0;
+    size_ = 0;
+}
+
+/**
+ * @brief Copies the unsent data into one string, meant for tests and logging.
+ */
+std::string SendQueue::toString() const {
+    std::string data;
+    data.reserve(size_);
+    for (std::deque<Chunk>::const_iterator it = chunks_.begin(); it != chunks_.end(); it++) {
+        unsigned long offset = (it == chunks_.begin()) ? frontOffset_ : 0;
+        data.append(it->data(), offset, std::string::npos);
+    }
+    return data;
+}
+
+}  // namespace irc
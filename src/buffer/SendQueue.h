@@ -0,0 +1,72 @@
+#ifndef SENDQUEUE_H
+#define SENDQUEUE_H
+
+#include <sys/uio.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "../common/magicNumber.h"
+#include "../common/replyBuilder.h"
+
+namespace irc {
+
+/**
+ * @brief An immutable serialized message that several send queues can hold at once.
+ */
+typedef std::shared_ptr<const std::string> SharedPayload;
+
+/**
+ * @class SendQueue
+ * @brief Outgoing data of a client, kept as a queue of chunks for writev()/sendmsg().
+ *
+ * Small messages are coalesced into the last chunk until it reaches SEND_QUEUE_CHUNK_SIZE,
+ * bigger ones get a chunk of their own. A partial write only advances the offset into the
+ * first chunk and drops the chunks that were sent completely, so the queued backlog is never
+ * moved in memory, no matter how slowly the client reads.
+ *
+ * A ReplyBuilder is written straight into the last chunk, so a reply usually costs no allocation.
+ *
+ * A SharedPayload is queued as a chunk of its own without copying it, so a message
+ * broadcast to many clients exists once in memory and every queue only holds a reference.
+ */
+class SendQueue {
+   public:
+    SendQueue();
+
+    void append(const std::string& packet);
+    void append(const SharedPayload& payload);
+    void append(const ReplyBuilder& reply);
+    int gather(struct iovec* iovecs, int maxIovecs) const;
+    void consume(unsigned long sentSize);
+    void prepend(SendQueue& unsent);
+    void swap(SendQueue& other);
+
+    unsigned long size() const;
+    bool empty() const;
+    unsigned long getChunkCount() const;
+    void clear();
+    std::string toString() const;
+
+   private:
+    /**
+     * @brief Either data owned by this queue, which later messages can be coalesced into,
+     * or a reference to a payload shared with other queues.
+     */
+    struct Chunk {
+        std::string owned;
+        SharedPayload shared;
+        const std::string& data() const;
+    };
+
+    std::string& ownedTail_(unsigned long length);
+
+    std::deque<Chunk> chunks_;
+    unsigned long frontOffset_;  // amount of bytes of the first chunk that were already sent
+    unsigned long size_;
+};
+
+}  // namespace irc
+
+#endif
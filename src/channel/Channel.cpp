@@ -1,33 +1,70 @@
 #include "Channel.h"
+#include "ChannelTable.h"
 
 namespace irc {
 
+std::atomic<unsigned long> Channel::fanoutEpoch_(0);
+
 // TODO: Maybe unrecord the channel from all clients, and erase from allChannels_?
 Channel::~Channel() {}
 
-Channel::Channel(Client& creatorClient, const std::string& name, std::map<std::string, Channel>& allChannels)
-    : name_(name), isInviteOnly_(false), isTopicProtected_(false), userLimit_(CHANNEL_USER_LIMIT_DISABLED), allChannels_(allChannels) {
+Channel::Channel(Client& creatorClient, const std::string& name, ChannelTable& allChannels)
+    : name_(name),
+      operatorCount_(0),
+      names_(namesLineLength_(name)),
+      isInviteOnly_(false),
+      isTopicProtected_(false),
+      userLimit_(CHANNEL_USER_LIMIT_DISABLED),
+      allChannels_(allChannels) {
 
     if (!isChannelNameValid(name) || !isChannelNameFree(name, allChannels_)) {
         throw std::invalid_argument("Channel name is invalid or taken");
     }
     members_.push_back(&creatorClient);
-    operators_.push_back(&creatorClient);
-    creatorClient.recordMyChannel(name_);
+    addFlag_(creatorClient, MEMBERSHIP_MEMBER);
+    addFlag_(creatorClient, MEMBERSHIP_OPERATOR);
+    operatorCount_++;
+    creatorClient.recordMyChannel(this);
     LOG_DEBUG("Channel::Channel: channel " << name_ << " created by " << creatorClient.getNickname());
 }
 
-std::string Channel::getName() const {
+const std::string& Channel::getName() const {
     return name_;
 }
 
+/**
+ * @brief Sends message to every member. It is serialized once and shared by all their send queues.
+ */
 void Channel::sendMessageToMembers(const std::string& message) {
+    SharedPayload payload = std::make_shared<const std::string>(message);
+    for (Client* member : members_) {
+        member->appendToSendBuffer(payload);
+    }
+}
+
+/**
+ * @brief Renders message once, in a payload of exactly its size that every member shares.
+ */
+void Channel::sendMessageToMembers(const ReplyBuilder& message) {
+    SharedPayload payload = std::make_shared<const std::string>(message.toString());
     for (Client* member : members_) {
-        member->appendToSendBuffer(message);
+        member->appendToSendBuffer(payload);
     }
 }
 
 void Channel::sendMessageToMembersExcluding(const std::string& message, const Client& excludedClient) {
+    sendMessageToMembersExcluding(std::make_shared<const std::string>(message), excludedClient);
+}
+
+void Channel::sendMessageToMembersExcluding(const ReplyBuilder& message, const Client& excludedClient) {
+    sendMessageToMembersExcluding(std::make_shared<const std::string>(message.toString()), excludedClient);
+}
+
+/**
+ * @brief Sends an already shared message to every member but excludedClient.
+ * Lets a message for several channels (QUIT, NICK) be serialized only once.
+ */
+void Channel::sendMessageToMembersExcluding(const SharedPayload& message, const Client& excludedClient) {
     for (Client* member : members_) {
         if (member->getFd() != excludedClient.getFd()) {
             member->appendToSendBuffer(message);
@@ -35,6 +72,24 @@ void Channel::sendMessageToMembersExcluding(const std::string& message, const Cl
     }
 }
 
+/**
+ * @brief Sends message once to every client sharing at least one channel with client, which is left out.
+ *
+ * Each call takes a new epoch and marks every recipient with it, so a neighbour met again in another
+ * of the channels is skipped without building a set of recipients (used by QUIT and NICK).
+ */
+void Channel::sendMessageToNeighbours(Client& client, const SharedPayload& message) {
+    unsigned long epoch = ++fanoutEpoch_;
+    client.markFanout(epoch);
+    for (Channel* channel : client.getMyChannels()) {
+        for (Client* member : channel->members_) {
+            if (member->markFanout(epoch)) {
+                member->appendToSendBuffer(message);
+            }
+        }
+    }
+}
+
 void Channel::setTopic(const std::string& topic) {
     topic_ = topic;
 }
@@ -89,7 +144,8 @@ void Channel::joinMember(Client& client) {
         return;
     }
     members_.push_back(&client);
-    client.recordMyChannel(name_);
+    addFlag_(client, MEMBERSHIP_MEMBER);
+    client.recordMyChannel(this);
     LOG_DEBUG("Channel::joinMember: client " << client.getNickname() << " joined channel " << name_);
 }
 
@@ -102,34 +158,31 @@ void Channel::joinMember(Client& client) {
  * if the client is not a member
  */
 int Channel::partMember(Client& client) {
-    int clientFd = client.getFd();
-
     if (!isMember(client)) {
         LOG_WARNING("Channel::partMember: client is not a member, not parting nick " << client.getNickname() << " from channel " << name_);
         return CHANNEL_PART_FAILURE;
     }
 
-    for (auto it = members_.begin(); it != members_.end(); it++) {
-        if ((*it)->getFd() == clientFd) {
-            client.unrecordMyChannel(name_);
-            if (isOperator(client)) {
-                LOG_DEBUG("Channel::partMember: client " << client.getNickname() << " was an operator, removing");
-                setOperatorStatus(client, false);
-            }
-            if (isInvited(client)) {
-                uninvite(client);
-            }
-            members_.erase(it);
-            if (operators_.empty()) {
-                LOG_DEBUG("Channel::partMember: no operators left, a new operator should be assigned: " << name_);
-                if (!members_.empty()) {
-                    setOperatorStatus(*members_.front(), true);
-                }
-            }
-            LOG_DEBUG("Channel::partMember: client " << client.getNickname() << " parted from channel " << name_);
-            break;
+    client.unrecordMyChannel(this);
+    if (isOperator(client)) {
+        LOG_DEBUG("Channel::partMember: client " << client.getNickname() << " was an operator, removing");
+        setOperatorStatus(client, false);
+    }
+    if (isInvited(client)) {
+        uninvite(client);
+    }
+    // The pointer that was pushed on join, which may be another copy of the client than the one parting
+    Client* joined = memberships_.at(client.getFd()).client;
+    members_.erase(std::find(members_.begin(), members_.end(), joined));
+    removeFlag_(client, MEMBERSHIP_MEMBER);
+    if (operatorCount_ == 0) {
+        LOG_DEBUG("Channel::partMember: no operators left, a new operator should be assigned: " << name_);
+        if (!members_.empty()) {
+            setOperatorStatus(*members_.front(), true);
         }
     }
+    LOG_DEBUG("Channel::partMember: client " << client.getNickname() << " parted from channel " << name_);
+
     int membersLeft = static_cast<int>(members_.size());
     if (members_.empty()) {
         LOG_DEBUG("Channel::partMember: no members left, deleted channel: " << name_);
@@ -139,18 +192,10 @@ int Channel::partMember(Client& client) {
 }
 
 bool Channel::isMember(Client& client) {
-    int clientFd = client.getFd();
-    for (Client* member : members_) {
-        if (member->getFd() == clientFd) {
-            return true;
-        }
-    }
-    return false;
+    return hasFlag_(client, MEMBERSHIP_MEMBER);
 }
 
 void Channel::setOperatorStatus(Client& client, bool setOperatorStatusTo) {
-    int clientFd = client.getFd();
-
     // If the client is not a member, do not set operator status
     if (!isMember(client)) {
         LOG_WARNING("Channel::setOperatorStatus: client is not a member, not setting operator status");
@@ -160,48 +205,34 @@ void Channel::setOperatorStatus(Client& client, bool setOperatorStatusTo) {
     bool isOp = isOperator(client);
     // Setting operator status to true
     if (setOperatorStatusTo) {
-        // Client is an operator, do not add to operators_
+        // Client is an operator, nothing to add
         if (isOp) {
             LOG_WARNING("Channel::setOperatorStatus: client is already an operator, not setting operator status for "
                         << client.getNickname() << " in " << name_);
             return;
         }
 
-        // Client is not an operator, add to operators_
-        operators_.push_back(&client);
+        addFlag_(client, MEMBERSHIP_OPERATOR);
+        operatorCount_++;
         LOG_DEBUG("Channel::setOperatorStatus: operator status added to " << client.getNickname() << " in channel " << name_);
         return;
     }
 
     // Setting operator status to false
-    // Client is not not an operator, do not remove from operators_
+    // Client is not not an operator, nothing to remove
     if (!isOp) {
         LOG_WARNING("Channel::setOperatorStatus: client is not an operator, not removing operator status for " << client.getNickname()
                                                                                                                << " in " << name_);
         return;
     }
 
-    // Client is an operator, remove from operators_
-    for (auto it = operators_.begin(); it != operators_.end(); it++) {
-        if ((*it)->getFd() == clientFd) {
-            operators_.erase(it);
-            LOG_DEBUG("Channel::setOperatorStatus: operator status removed from " << client.getNickname() << " in channel " << name_);
-            return;
-        }
-    }
-
-    LOG_ERROR("Channel::setOperatorStatus: client is an operator, but not found in operators_, nick: " << client.getNickname() << " in "
-                                                                                                       << name_);
+    removeFlag_(client, MEMBERSHIP_OPERATOR);
+    operatorCount_--;
+    LOG_DEBUG("Channel::setOperatorStatus: operator status removed from " << client.getNickname() << " in channel " << name_);
 }
 
 bool Channel::isOperator(Client& client) {
-    int clientFd = client.getFd();
-    for (Client* operator_ : operators_) {
-        if (operator_->getFd() == clientFd) {
-            return true;
-        }
-    }
-    return false;
+    return hasFlag_(client, MEMBERSHIP_OPERATOR);
 }
 
 void Channel::invite(Client& client) {
@@ -210,52 +241,39 @@ void Channel::invite(Client& client) {
         return;
     }
     LOG_DEBUG("Channel::invite: inviting client " << client.getNickname() << " to channel " << name_);
-    invited_.push_back(&client);
+    addFlag_(client, MEMBERSHIP_INVITED);
 }
 
 void Channel::uninvite(Client& client) {
-    int clientFd = client.getFd();
-    for (auto it = invited_.begin(); it != invited_.end(); it++) {
-        if ((*it)->getFd() == clientFd) {
-            LOG_DEBUG("Channel::uninvite: uninviting client " << client.getNickname() << " from channel " << name_);
-            invited_.erase(it);
-            return;
-        }
+    if (!isInvited(client)) {
+        LOG_WARNING("Channel::uninvite: client is not invited, not uninviting");
+        return;
     }
-    LOG_WARNING("Channel::uninvite: client is not invited, not uninviting");
+    LOG_DEBUG("Channel::uninvite: uninviting client " << client.getNickname() << " from channel " << name_);
+    removeFlag_(client, MEMBERSHIP_INVITED);
 }
 
 bool Channel::isInvited(Client& client) {
-    int clientFd = client.getFd();
-    for (Client* invited : invited_) {
-        if (invited->getFd() == clientFd) {
-            return true;
-        }
-    }
-    return false;
+    return hasFlag_(client, MEMBERSHIP_INVITED);
 }
 
 bool Channel::isChannelNameValid(const std::string& name) {
-    std::regex pattern(R"(^[&#][a-zA-Z0-9_-]+$)", std::regex::icase);
-
     if (name.length() < MIN_CHANNELNAME_LENGTH || name.length() > MAX_CHANNELNAME_LENGTH) {
         LOG_DEBUG("Channel::isChannelNameValid: name length is invalid");
         return false;
     }
-    if (std::regex_match(name, pattern)) {
+    if (matchesChannelNamePattern(name.data(), name.size())) {
         return true;
     }
     LOG_DEBUG("Channel::isChannelNameValid: name does not match pattern");
     return false;
 }
 
-bool Channel::isChannelNameFree(const std::string& name, std::map<std::string, Channel>& allChannels) {
-    for (auto it = allChannels.begin(); it != allChannels.end(); it++) {
-        if (it->second.getName() == name) {
-            return false;
-        }
-    }
-    return true;
+/**
+ * @brief Tells if no channel uses name, compared under IRC casemapping.
+ */
+bool Channel::isChannelNameFree(const std::string& name, ChannelTable& allChannels) {
+    return allChannels.getOrNull(name) == nullptr;
 }
 
 unsigned long Channel::getMemberCount() const {
@@ -266,28 +284,108 @@ std::vector<Client*>& Channel::getMembers() {
     return members_;
 }
 
+/**
+ * @brief The names of all members, separated by spaces. JOIN sends getNamesLines() instead.
+ */
 std::string Channel::getNamesList() {
     std::string namesList;
-    for (Client* member : members_) {
-        if (isOperator(*member)) {
-            namesList.append(CHANNEL_OPERATOR_SYMBOL);
+    for (const std::string& line : names_.getLines()) {
+        if (line.empty() == false) {
+            namesList.append(namesList.empty() ? "" : " ").append(line);
         }
-        namesList.append(member->getNickname() + " ");
     }
-    // get rid of the trailing space
-    namesList.pop_back();
     return namesList;
 }
 
+/**
+ * @brief The names of all members in lines that each fit a RPL_NAMREPLY_353, empty ones are to be skipped.
+ */
+const std::vector<std::string>& Channel::getNamesLines() const {
+    return names_.getLines();
+}
+
+/**
+ * @brief Renders the name of client again after its nickname changed.
+ */
+void Channel::refreshMemberName(Client& client) {
+    if (isMember(client)) {
+        names_.set(client.getFd(), (isOperator(client) ? CHANNEL_OPERATOR_SYMBOL : "") + client.getNickname());
+    }
+}
+
 Client* Channel::getMemberByNicknameOrNull(const std::string& nickname) {
     for (Client* member : members_) {
-        if (member->getNickname() == nickname) {
+        if (casefoldEquals(member->getNickname(), nickname)) {
             return member;
         }
     }
     return nullptr;
 }
 
+bool Channel::hasFlag_(const Client& client, MembershipFlag flag) const {
+    auto it = memberships_.find(client.getFd());
+    return it != memberships_.end() && (it->second.flags & flag) != 0;
+}
+
+/**
+ * @brief Sets flag for client, creating its entry on the first flag. Joining points the entry at the Client in members_.
+ */
+void Channel::addFlag_(Client& client, MembershipFlag flag) {
+    Membership& membership = memberships_.insert(std::make_pair(client.getFd(), Membership{&client, 0})).first->second;
+    membership.flags = static_cast<unsigned char>(membership.flags | flag);
+    if (flag == MEMBERSHIP_MEMBER) {
+        membership.client = &client;
+    }
+    if (flag != MEMBERSHIP_INVITED) {
+        refreshMemberName(client);
+    }
+}
+
+/**
+ * @brief Clears flag for client, dropping its entry with the last flag.
+ */
+void Channel::removeFlag_(const Client& client, MembershipFlag flag) {
+    auto it = memberships_.find(client.getFd());
+    if (it == memberships_.end()) {
+        return;
+    }
+    it->second.flags = static_cast<unsigned char>(it->second.flags & ~flag);
+    if (flag == MEMBERSHIP_MEMBER) {
+        names_.erase(client.getFd());
+    } else if (flag == MEMBERSHIP_OPERATOR && (it->second.flags & MEMBERSHIP_MEMBER) != 0) {
+        names_.set(client.getFd(), client.getNickname());
+    }
+    if (it->second.flags == 0) {
+        memberships_.erase(it);
+    }
+}
+
+/**
+ * @brief The room for names in a RPL_NAMREPLY_353 of the channel name that stays within MAX_MSG_LENGTH,
+ * whatever the nickname of the client it is sent to.
+ */
+unsigned long Channel::namesLineLength_(const std::string& name) {
+    std::string longestNickname(NICK_MAX_LENGTH_RFC2812, 'n');
+    return MAX_MSG_LENGTH - RPL_NAMREPLY_353(serverHostname_g, longestNickname, CHANNEL_SYMBOL_PUBLIC, name, "").size();
+}
+
+/**
+ * @brief Parses the parameter of +l like std::stoi would, but reports a bad one with FAILURE instead of throwing.
+ *
+ * Leading whitespace and trailing garbage are accepted as before; no digits or a value out of int range are not.
+ */
+int Channel::parseUserLimit_(const std::string& param, int& userLimit) {
+    const char* begin = param.c_str();
+    char* end = NULL;
+    errno = 0;
+    long value = std::strtol(begin, &end, 10);
+    if (end == begin || errno == ERANGE || value > INT_MAX || value < INT_MIN) {
+        return FAILURE;
+    }
+    userLimit = static_cast<int>(value);
+    return SUCCESS;
+}
+
 int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
     Client* clientToSetOperatorStatus = nullptr;
     int userLimit = userLimit_;
@@ -302,15 +400,13 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
             if (modeStruct.modifier == '+') {
                 // invite-only mode is being set even if it's already set
                 setInviteOnly(true);
-                sendMessageToMembers(
-                    COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE", name_ + " +i"));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " +i"));
                 return SUCCESS;
             }
             if (modeStruct.modifier == '-') {
                 // invite-only mode is being unset even if it's already unset
                 setInviteOnly(false);
-                sendMessageToMembers(
-                    COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE", name_ + " -i"));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " -i"));
                 return SUCCESS;
             }
             return FAILURE;
@@ -324,15 +420,13 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
             if (modeStruct.modifier == '+') {
                 // topic-protected mode is being set even if it's already set
                 setTopicProtected(true);
-                sendMessageToMembers(
-                    COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE", name_ + " +t"));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " +t"));
                 return SUCCESS;
             }
             if (modeStruct.modifier == '-') {
                 // topic-protected mode is being unset even if it's already unset
                 setTopicProtected(false);
-                sendMessageToMembers(
-                    COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE", name_ + " -t"));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " -t"));
                 return SUCCESS;
             }
             return FAILURE;
@@ -349,8 +443,7 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
                     return FAILURE;
                 }
                 setKey(modeStruct.param);
-                sendMessageToMembers(COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE",
-                                                 name_ + " +k " + modeStruct.param));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " +k ", modeStruct.param));
                 return SUCCESS;
             }
             if (modeStruct.modifier == '-') {
@@ -368,8 +461,7 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
                     return FAILURE;
                 }
                 setKey("");
-                sendMessageToMembers(COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE",
-                                                 name_ + " -k " + modeStruct.param));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " -k ", modeStruct.param));
                 return SUCCESS;
             }
             return FAILURE;
@@ -390,15 +482,13 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
             if (modeStruct.modifier == '+') {
                 // operator mode is being set even if it's already set
                 setOperatorStatus(*clientToSetOperatorStatus, true);
-                sendMessageToMembers(COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE",
-                                                 name_ + " +o " + modeStruct.param));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " +o ", clientToSetOperatorStatus->getNickname()));
                 return SUCCESS;
             }
             if (modeStruct.modifier == '-') {
                 // operator mode is being unset even if it's already unset
                 setOperatorStatus(*clientToSetOperatorStatus, false);
-                sendMessageToMembers(COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE",
-                                                 name_ + " -o " + modeStruct.param));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " -o ", clientToSetOperatorStatus->getNickname()));
                 return SUCCESS;
             }
             return FAILURE;
@@ -410,21 +500,18 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
                     allowedClient.appendToSendBuffer(RPL_ERR_NEEDMOREPARAMS_461(serverHostname_g, allowedClient.getNickname(), "MODE"));
                     return FAILURE;
                 }
-                try {
-                    userLimit = std::stoi(modeStruct.param);
-                    if (userLimit < 0) {
-                        LOG_DEBUG("Channel::handleModeChange: l: +l with a negative int parameter, not setting");
-                        allowedClient.appendToSendBuffer(RPL_ERR_NEEDMOREPARAMS_461(serverHostname_g, allowedClient.getNickname(), "MODE"));
-                        return FAILURE;
-                    }
-                } catch (std::out_of_range& e) {
+                if (parseUserLimit_(modeStruct.param, userLimit) == FAILURE) {
                     LOG_DEBUG("Channel::handleModeChange: l: +l with a non-int parameter, not setting");
                     allowedClient.appendToSendBuffer(RPL_ERR_NEEDMOREPARAMS_461(serverHostname_g, allowedClient.getNickname(), "MODE"));
                     return FAILURE;
                 }
+                if (userLimit < 0) {
+                    LOG_DEBUG("Channel::handleModeChange: l: +l with a negative int parameter, not setting");
+                    allowedClient.appendToSendBuffer(RPL_ERR_NEEDMOREPARAMS_461(serverHostname_g, allowedClient.getNickname(), "MODE"));
+                    return FAILURE;
+                }
                 setUserLimit(userLimit);
-                sendMessageToMembers(COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE",
-                                                 name_ + " +l " + std::to_string(userLimit)));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " +l ", std::to_string(userLimit)));
                 return SUCCESS;
             }
             if (modeStruct.modifier == '-') {
@@ -435,8 +522,7 @@ int Channel::handleModeChange(Client& allowedClient, modestruct& modeStruct) {
                 }
                 // user-limit mode is being unset even if it's already unset
                 setUserLimit(CHANNEL_USER_LIMIT_DISABLED);
-                sendMessageToMembers(
-                    COM_MESSAGE(allowedClient.getNickname(), allowedClient.getUserName(), allowedClient.getHost(), "MODE", name_ + " -l"));
+                sendMessageToMembers(PREFIXED_MESSAGE(allowedClient.getPrefix(), "MODE", name_, " -l"));
                 return SUCCESS;
             }
             return FAILURE;
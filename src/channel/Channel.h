@@ -1,22 +1,47 @@
 #ifndef CHANNEL_H
 #define CHANNEL_H
 
-#include <map>
-#include <regex>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../client/Client.h"
+#include "../common/casefold.h"
+#include "../common/charclass.h"
+#include "NamesList.h"
 
 extern std::string serverHostname_g;
 
 namespace irc {
 
+class ChannelTable;
+
+/**
+ * @class Channel
+ * @brief A channel, its modes and what each client is to it.
+ *
+ * Membership, operator status and invitations are flag bits of one entry per client fd,
+ * so checking any of them is a single hash lookup. The members are also kept in join
+ * order, which fanout and picking the next operator iterate. The NAMES reply is kept
+ * rendered in a NamesList that every change of a member's name or operator status updates.
+ */
 class Channel {
    public:
+    enum MembershipFlag {
+        MEMBERSHIP_MEMBER = 1,
+        MEMBERSHIP_OPERATOR = 2,
+        MEMBERSHIP_INVITED = 4,
+    };
+
     ~Channel();
-    Channel(Client& creatorClient, const std::string& name, std::map<std::string, Channel>& allChannels);
+    Channel(Client& creatorClient, const std::string& name, ChannelTable& allChannels);
 
     struct modestruct {
         char modifier;
@@ -24,9 +49,13 @@ class Channel {
         std::string param;
     };
 
-    std::string getName() const;
+    const std::string& getName() const;
     void sendMessageToMembers(const std::string& message);
+    void sendMessageToMembers(const ReplyBuilder& message);
     void sendMessageToMembersExcluding(const std::string& message, const Client& excludedClient);
+    void sendMessageToMembersExcluding(const ReplyBuilder& message, const Client& excludedClient);
+    void sendMessageToMembersExcluding(const SharedPayload& message, const Client& excludedClient);
+    static void sendMessageToNeighbours(Client& client, const SharedPayload& message);
     void setTopic(const std::string& topic);
     std::string getTopic() const;
     void setKey(const std::string& key);
@@ -48,22 +77,41 @@ class Channel {
     unsigned long getMemberCount() const;
     std::vector<Client*>& getMembers();
     std::string getNamesList();
+    const std::vector<std::string>& getNamesLines() const;
+    void refreshMemberName(Client& client);
     static bool isChannelNameValid(const std::string& name);
-    static bool isChannelNameFree(const std::string& name, std::map<std::string, Channel>& allChannels);
+    static bool isChannelNameFree(const std::string& name, ChannelTable& allChannels);
     int handleModeChange(Client& allowedClient, modestruct& modeStruct);
     Client* getMemberByNicknameOrNull(const std::string& nickname);
 
    private:
+    struct Membership {
+        Client* client;
+        unsigned char flags;
+    };
+
     std::string name_;
-    std::vector<Client*> invited_;
-    std::vector<Client*> members_;
-    std::vector<Client*> operators_;
+    std::unordered_map<int, Membership> memberships_;  // keyed by fd, an entry has at least one flag
+    std::vector<Client*> members_;                     // in join order
+    unsigned long operatorCount_;
+    NamesList names_;
+    static std::atomic<unsigned long> fanoutEpoch_;
     std::string topic_;
     std::string key_;
     bool isInviteOnly_;
     bool isTopicProtected_;
     int userLimit_;
-    std::map<std::string, Channel>& allChannels_;
+    ChannelTable& allChannels_;
+
+    bool hasFlag_(const Client& client, MembershipFlag flag) const;
+    void addFlag_(Client& client, MembershipFlag flag);
+    void removeFlag_(const Client& client, MembershipFlag flag);
+    static unsigned long namesLineLength_(const std::string& name);
+    // Clients hold the address of their channels, so a channel is built in place and never copied
+    Channel(const Channel& other);
+    Channel& operator=(const Channel& other);
+
+    static int parseUserLimit_(const std::string& param, int& userLimit);
 };
 
 }  // namespace irc
@@ -0,0 +1,56 @@
+#include "ChannelTable.h"
+
+namespace irc {
+
+ChannelTable::ChannelTable() {}
+
+ChannelTable::~ChannelTable() {}
+
+/**
+ * @brief Creates the channel name with creator as its first member and operator.
+ *
+ * @return Channel* The new channel, or nullptr if name is invalid or taken under IRC casemapping.
+ */
+Channel* ChannelTable::insert(Client& creator, const std::string& name) {
+    if (!Channel::isChannelNameValid(name) || getOrNull(name) != nullptr) {
+        LOG_WARNING("ChannelTable::insert: channel name " << name << " is invalid or already taken");
+        return nullptr;
+    }
+    return &byName_.emplace(std::piecewise_construct, std::forward_as_tuple(casefold(name)), std::forward_as_tuple(creator, name, *this))
+                .first->second;
+}
+
+/**
+ * @brief Finds the channel whose name equals name under IRC casemapping.
+ *
+ * @return Channel* The channel, or nullptr if there is none.
+ */
+Channel* ChannelTable::getOrNull(const std::string& name) {
+    std::unordered_map<std::string, Channel>::iterator it = byName_.find(casefold(name));
+    if (it == byName_.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+/**
+ * @brief Destroys the channel name.
+ *
+ * @return int SUCCESS if a channel was erased, FAILURE if there was none.
+ */
+int ChannelTable::erase(const std::string& name) {
+    if (byName_.erase(casefold(name)) == 0) {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+unsigned long ChannelTable::size() const {
+    return byName_.size();
+}
+
+bool ChannelTable::empty() const {
+    return byName_.empty();
+}
+
+}  // namespace irc
@@ -0,0 +1,42 @@
+#ifndef CHANNELTABLE_H
+#define CHANNELTABLE_H
+
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "../common/casefold.h"
+#include "Channel.h"
+
+namespace irc {
+
+/**
+ * @class ChannelTable
+ * @brief The channels, indexed by their casefolded name.
+ *
+ * Names are compared under IRC casemapping, so "#Foo" and "#foo" are one channel,
+ * which keeps the spelling it was created with. Resolving a name is a single hash
+ * lookup, and the channels stay at the same address until they are erased.
+ */
+class ChannelTable {
+   public:
+    ChannelTable();
+    ~ChannelTable();
+
+    Channel* insert(Client& creator, const std::string& name);
+    Channel* getOrNull(const std::string& name);
+    int erase(const std::string& name);
+    unsigned long size() const;
+    bool empty() const;
+
+   private:
+    ChannelTable(const ChannelTable& other);
+    ChannelTable& operator=(const ChannelTable& other);
+
+    std::unordered_map<std::string, Channel> byName_;  // keyed by the casefolded name
+};
+
+}  // namespace irc
+
+#endif
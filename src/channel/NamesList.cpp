@@ -0,0 +1,133 @@
+#include "NamesList.h"
+
+namespace irc {
+
+NamesList::NamesList(unsigned long maxLineLength) : maxLineLength_(maxLineLength), filledLength_(0) {}
+
+/**
+ * @brief Adds the name of fd, or replaces it where it stands if fd is listed already.
+ *
+ * A replacement that no longer fits its line moves the name to the last line.
+ */
+void NamesList::set(int fd, const std::string& name) {
+    std::unordered_map<int, Entry>::iterator it = entries_.find(fd);
+    if (it == entries_.end()) {
+        Entry& entry = entries_[fd];
+        entry.name = name;
+        append_(fd, entry);
+        return;
+    }
+    Entry& entry = it->second;
+    if (entry.name == name) {
+        return;
+    }
+    std::string& line = lines_[entry.line];
+    if (line.size() - entry.name.size() + name.size() <= maxLineLength_) {
+        unsigned long index;
+        line.replace(offsetInLine_(fd, entry, index), entry.name.size(), name);
+        filledLength_ = filledLength_ - entry.name.size() + name.size();
+        entry.name = name;
+        return;
+    }
+    removeFromLine_(fd, entry);
+    entry.name = name;
+    append_(fd, entry);
+}
+
+void NamesList::erase(int fd) {
+    std::unordered_map<int, Entry>::iterator it = entries_.find(fd);
+    if (it == entries_.end()) {
+        return;
+    }
+    removeFromLine_(fd, it->second);
+    entries_.erase(it);
+    while (lines_.empty() == false && lines_.back().empty()) {
+        lines_.pop_back();
+        lineFds_.pop_back();
+    }
+    compactIfSparse_();
+}
+
+/**
+ * @brief The rendered lines in member order, empty ones are to be skipped.
+ */
+const std::vector<std::string>& NamesList::getLines() const {
+    return lines_;
+}
+
+unsigned long NamesList::size() const {
+    return entries_.size();
+}
+
+/**
+ * @brief Appends entry to the last line, or to a new one if it does not fit.
+ */
+void NamesList::append_(int fd, Entry& entry) {
+    unsigned long separator = (lines_.empty() || lines_.back().empty()) ? 0 : 1;
+    if (lines_.empty() || lines_.back().size() + separator + entry.name.size() > maxLineLength_) {
+        lines_.push_back(std::string());
+        lineFds_.push_back(std::vector<int>());
+        separator = 0;
+    }
+    if (separator != 0) {
+        lines_.back().push_back(' ');
+    }
+    lines_.back().append(entry.name);
+    lineFds_.back().push_back(fd);
+    filledLength_ += separator + entry.name.size();
+    entry.line = lines_.size() - 1;
+}
+
+/**
+ * @brief Cuts the name of entry and one space next to it out of its line.
+ */
+void NamesList::removeFromLine_(int fd, const Entry& entry) {
+    std::string& line = lines_[entry.line];
+    std::vector<int>& fds = lineFds_[entry.line];
+    unsigned long index;
+    unsigned long offset = offsetInLine_(fd, entry, index);
+    unsigned long length = entry.name.size();
+    if (fds.size() > 1) {
+        length++;
+        if (index != 0) {
+            offset--;  // the space in front, the first name takes the one behind it
+        }
+    }
+    line.erase(offset, length);
+    fds.erase(fds.begin() + static_cast<long>(index));
+    filledLength_ -= length;
+}
+
+/**
+ * @brief Where the name of entry starts in its line, walking the names in front of it.
+ *
+ * @param index Set to the position of fd among the fds of the line.
+ */
+unsigned long NamesList::offsetInLine_(int fd, const Entry& entry, unsigned long& index) const {
+    const std::vector<int>& fds = lineFds_[entry.line];
+    unsigned long offset = 0;
+    for (index = 0; fds[index] != fd; index++) {
+        offset += entries_.at(fds[index]).name.size() + 1;
+    }
+    return offset;
+}
+
+/**
+ * @brief Packs the names again in order once there are more than twice the lines they need.
+ */
+void NamesList::compactIfSparse_() {
+    if (lines_.size() <= 2 * (filledLength_ / maxLineLength_ + 1)) {
+        return;
+    }
+    std::vector<std::vector<int> > previousLineFds;
+    previousLineFds.swap(lineFds_);
+    lines_.clear();
+    filledLength_ = 0;
+    for (const std::vector<int>& fds : previousLineFds) {
+        for (int fd : fds) {
+            append_(fd, entries_.at(fd));
+        }
+    }
+}
+
+}  // namespace irc
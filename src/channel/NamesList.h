@@ -0,0 +1,49 @@
+#ifndef NAMESLIST_H
+#define NAMESLIST_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace irc {
+
+/**
+ * @class NamesList
+ * @brief The names of a channel's members, kept rendered as lines of space-separated names.
+ *
+ * No line grows past maxLineLength bytes, so each one fits a RPL_NAMREPLY_353 of legal length.
+ * A name is appended to the last line, replaced where it stands or removed from its line, so
+ * joining, parting, a nickname or an operator change costs the length of one line instead of
+ * rendering every member again. Lines emptied by parts are dropped once they outnumber the
+ * filled ones, by packing the names again in the same order.
+ */
+class NamesList {
+   public:
+    explicit NamesList(unsigned long maxLineLength);
+
+    void set(int fd, const std::string& name);
+    void erase(int fd);
+    const std::vector<std::string>& getLines() const;
+    unsigned long size() const;
+
+   private:
+    struct Entry {
+        std::string name;
+        unsigned long line;
+    };
+
+    unsigned long maxLineLength_;
+    std::vector<std::string> lines_;           // some may be empty after parts
+    std::vector<std::vector<int> > lineFds_;   // the fds of each line, in the order of its names
+    std::unordered_map<int, Entry> entries_;   // keyed by fd
+    unsigned long filledLength_;               // the bytes of all lines together
+
+    void append_(int fd, Entry& entry);
+    void removeFromLine_(int fd, const Entry& entry);
+    unsigned long offsetInLine_(int fd, const Entry& entry, unsigned long& index) const;
+    void compactIfSparse_();
+};
+
+}  // namespace irc
+
+#endif
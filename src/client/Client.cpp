@@ -1,8 +1,21 @@
 #include "Client.h"
+#include "../channel/Channel.h"
+#include "ClientTable.h"
 
 namespace irc {
 
-Client::Client(int fd, const struct sockaddr& sockaddr) : fd_(fd), sockaddr_(sockaddr), nickname_("*") {
+// The client whose replies the calling thread keeps apart, see Client::deferReplies()
+static thread_local const Client* deferringClient_g = nullptr;
+
+Client::Client(int fd, const struct sockaddr& sockaddr)
+    : fd_(fd),
+      sockaddr_(sockaddr),
+      nickname_("*"),
+      clientTable_(nullptr),
+      pendingWriteQueue_(nullptr),
+      isWriteScheduled_(false),
+      isWriteInterestArmed_(false),
+      fanoutEpoch_(0) {
     status_.gotUser = false;
     status_.gotNick = false;
     status_.gotPassword = false;
@@ -17,6 +30,7 @@ bool Client::isAuthenticated() {
 }
 
 void Client::setNickname(const std::string& newNickname) {
+    bool wasIndexed = status_.gotNick;
     if (!status_.gotNick) {  // if the client is setting their nickname for the first time when they connect
         nickname_ = (newNickname.size() > NICK_MAX_LENGTH_RFC2812) ? newNickname.substr(0, NICK_MAX_LENGTH_RFC2812) : newNickname;
         setOldNickname_(nickname_);
@@ -29,6 +43,10 @@ void Client::setNickname(const std::string& newNickname) {
         setOldNickname_(nickname_);
         nickname_ = (newNickname.size() > NICK_MAX_LENGTH_RFC2812) ? newNickname.substr(0, NICK_MAX_LENGTH_RFC2812) : newNickname;
     }
+    prefix_.clear();
+    if (clientTable_ != nullptr) {
+        clientTable_->reindexNickname(*this, wasIndexed ? &oldNickname_ : nullptr);
+    }
     LOG_DEBUG("Client::setNickname: nickname is set to: " << nickname_);
 }
 
@@ -38,6 +56,7 @@ void Client::setOldNickname_(const std::string& oldNickname) {
 
 void Client::setUserName(const std::string& userName) {
     userName_ = userName;
+    prefix_.clear();
     status_.gotUser = true;
     if (status_.gotPassword && status_.gotNick) {
         status_.authenticated = true;
@@ -88,19 +107,42 @@ std::string& Client::getHost() {
     return ipAddr_;
 }
 
+/**
+ * @brief The source of the messages the client sends to others, ":nick!user@host".
+ *
+ * It is rendered on first use and kept until the nickname or the username changes, the
+ * host never does, so relaying a message does not rebuild it from copies of its parts.
+ */
+const std::string& Client::getPrefix() {
+    if (prefix_.empty()) {
+        FORMAT_NICK_USER_HOST(nickname_, userName_, getHost()).appendTo(prefix_);
+    }
+    return prefix_;
+}
+
 void Client::setSendBuffer(const std::string& sendBuffer) {
-    this->sendBuffer_ = sendBuffer;
+    sendQueue_.clear();
+    sendQueue_.append(sendBuffer);
+    schedulePendingWrite_();
 }
 
-std::string& Client::getSendBuffer() {
-    return sendBuffer_;
+/**
+ * @brief Returns a copy of the data waiting to be sent, the server sends from getSendQueue().
+ */
+std::string Client::getSendBuffer() const {
+    return sendQueue_.toString();
+}
+
+SendQueue& Client::getSendQueue() {
+    return sendQueue_;
 }
 
 void Client::setRecvBuffer(const std::string& recvBuffer) {
-    this->recvBuffer_ = recvBuffer;
+    recvBuffer_.clear();
+    recvBuffer_.append(recvBuffer);
 }
 
-std::string& Client::getRecvBuffer() {
+RecvBuffer& Client::getRecvBuffer() {
     return recvBuffer_;
 }
 
@@ -119,18 +161,51 @@ bool Client::isGotPassword() const {
 void Client::appendToSendBuffer(const std::string& packet) {
     LOG_DEBUG("Client::appendToSendBuffer: appending message to sendBuffer for nick "
               << nickname_ << " (excl.CRLF): " << packet.substr(0, packet.length() - 2));
-    sendBuffer_ += packet;
+    if (isDeferringReplies_()) {
+        deferredReplies_.append(packet);
+        return;
+    }
+    sendQueue_.append(packet);
+    schedulePendingWrite_();
+}
+
+/**
+ * @brief Queues a message that is shared with other clients, e.g. a channel broadcast, without copying it.
+ */
+void Client::appendToSendBuffer(const SharedPayload& payload) {
+    LOG_DEBUG("Client::appendToSendBuffer: appending shared message to sendBuffer for nick "
+              << nickname_ << " (excl.CRLF): " << payload->substr(0, payload->length() - 2));
+    if (isDeferringReplies_()) {
+        deferredReplies_.append(payload);
+        return;
+    }
+    sendQueue_.append(payload);
+    schedulePendingWrite_();
+}
+
+/**
+ * @brief Queues a reply built by the reply.h macros, it is written straight into the send queue.
+ */
+void Client::appendToSendBuffer(const ReplyBuilder& reply) {
+    LOG_DEBUG("Client::appendToSendBuffer: appending reply to sendBuffer for nick "
+              << nickname_ << " (excl.CRLF): " << reply.toString().substr(0, reply.size() - 2));
+    if (isDeferringReplies_()) {
+        deferredReplies_.append(reply);
+        return;
+    }
+    sendQueue_.append(reply);
+    schedulePendingWrite_();
 }
 
 void Client::appendToRecvBuffer(const std::string& packet) {
     LOG_DEBUG("Client::appendToRecvBuffer: appending message to recvBuffer for nick "
               << nickname_ << " (excl.CRLF): " << packet.substr(0, packet.length() - 2));
-    recvBuffer_ += packet;
+    recvBuffer_.append(packet);
 }
 
 void Client::clearSendBuffer() {
     LOG_DEBUG("Client::clearSendBuffer: clearing sendBuffer for nick " << nickname_);
-    sendBuffer_.clear();
+    sendQueue_.clear();
 }
 
 void Client::clearRecvBuffer() {
@@ -165,41 +240,122 @@ void Client::setDisconnectErrorReason(const std::string& reason) {
     disconnectErrorReason_ = reason;
 }
 
-void Client::recordMyChannel(std::string& channelName) {
-    myChannelsByName_.push_back(channelName);
-    LOG_DEBUG("Client::recordMyChannel: nick " << nickname_ << " recorded channel " << channelName);
+void Client::recordMyChannel(Channel* channel) {
+    myChannels_.push_back(channel);
+    LOG_DEBUG("Client::recordMyChannel: nick " << nickname_ << " recorded channel " << channel->getName());
 }
 
-void Client::unrecordMyChannel(std::string& channelName) {
-    std::vector<std::string>::iterator it = myChannelsByName_.begin();
-    while (it != myChannelsByName_.end()) {
-        if (*it == channelName) {
-            myChannelsByName_.erase(it);
-            LOG_DEBUG("Client::unrecordMyChannel: nick " << nickname_ << " unrecorded channel " << channelName);
-            break;
-        }
-        it++;
+void Client::unrecordMyChannel(Channel* channel) {
+    std::vector<Channel*>::iterator it = std::find(myChannels_.begin(), myChannels_.end(), channel);
+    if (it != myChannels_.end()) {
+        myChannels_.erase(it);
+        LOG_DEBUG("Client::unrecordMyChannel: nick " << nickname_ << " unrecorded channel " << channel->getName());
     }
 }
 
-std::vector<std::string>& Client::getMyChannels() {
-    return myChannelsByName_;
+/**
+ * @brief The channels the client joined, in join order. Parting one changes the vector, iterate a copy then.
+ */
+const std::vector<Channel*>& Client::getMyChannels() const {
+    return myChannels_;
 }
 
 void Client::processErrorMessage() {
     if (disconnectErrorReason_.empty() == false) {
-        sendBuffer_ += ERR_MESSAGE(disconnectErrorReason_);
+        appendToSendBuffer(ERR_MESSAGE(disconnectErrorReason_));
         disconnectErrorReason_.clear();
     }
 }
 
-bool Client::isMemberOfChannel(const std::string& channelName) {
-    for (std::string& myChannel : myChannelsByName_) {
-        if (channelName == myChannel) {
-            return true;
-        }
+bool Client::isMemberOfChannel(const Channel* channel) const {
+    return std::find(myChannels_.begin(), myChannels_.end(), channel) != myChannels_.end();
+}
+
+/**
+ * @brief Sets the queue where the client announces that it has data to send.
+ *
+ * The server owns the queue and flushes the announced clients once per loop iteration,
+ * so write interest only has to be armed for clients whose data did not fit into the socket.
+ * Clients without a queue (e.g. in unit tests) simply keep the data in their sendQueue_.
+ *
+ * @param pendingWriteQueue The queue of fds, or nullptr to stop announcing.
+ */
+void Client::setPendingWriteQueue(std::vector<int>* pendingWriteQueue) {
+    pendingWriteQueue_ = pendingWriteQueue;
+    isWriteScheduled_ = false;
+}
+
+/**
+ * @brief Sets the table the client is stored in, done by ClientTable::insert().
+ *
+ * @param clientTable The table whose nickname index setNickname() keeps up to date, or nullptr.
+ */
+void Client::setClientTable(ClientTable* clientTable) {
+    clientTable_ = clientTable;
+}
+
+void Client::schedulePendingWrite_() {
+    if (pendingWriteQueue_ == nullptr || isWriteScheduled_ || sendQueue_.empty()) {
+        return;
+    }
+    pendingWriteQueue_->push_back(fd_);
+    isWriteScheduled_ = true;
+}
+
+/**
+ * @brief Keeps the replies the calling thread queues for the client apart until mergeDeferredReplies().
+ *
+ * The reactor owning the client runs the commands that only touch it without the server state
+ * mutex (see Command::isSenderOnly()). Other reactors may queue data for the client meanwhile,
+ * so the replies of those commands go to a queue of their own that only the owner touches.
+ */
+void Client::deferReplies() {
+    deferringClient_g = this;
+}
+
+/**
+ * @brief Moves the deferred replies behind the data queued for the client and stops deferring.
+ * Must be called with the server state mutex held, like every other change of the send queue.
+ */
+void Client::mergeDeferredReplies() {
+    if (deferringClient_g == this) {
+        deferringClient_g = nullptr;
+    }
+    if (deferredReplies_.empty()) {
+        return;
     }
-    return false;
+    deferredReplies_.prepend(sendQueue_);
+    sendQueue_.swap(deferredReplies_);
+    schedulePendingWrite_();
+}
+
+bool Client::isDeferringReplies_() const {
+    return deferringClient_g == this;
+}
+
+void Client::unschedulePendingWrite() {
+    isWriteScheduled_ = false;
+}
+
+bool Client::isWriteInterestArmed() const {
+    return isWriteInterestArmed_;
+}
+
+/**
+ * @brief Marks the client as reached by the fanout epoch.
+ *
+ * @return bool true the first time it is called with epoch, false if the client was already reached by it.
+ */
+bool Client::markFanout(unsigned long epoch) {
+    if (fanoutEpoch_ == epoch) {
+        return false;
+    }
+    fanoutEpoch_ = epoch;
+    return true;
+}
+
+void Client::setWriteInterestArmed(bool isArmed) {
+    isWriteInterestArmed_ = isArmed;
 }
 
 }  // namespace irc
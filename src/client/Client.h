@@ -5,15 +5,21 @@
 #include <sys/poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "../buffer/RecvBuffer.h"
+#include "../buffer/SendQueue.h"
 #include "../common/log.h"
 #include "../common/magicNumber.h"
 #include "../common/reply.h"
 
 namespace irc {
 
+class Channel;
+class ClientTable;
+
 class Client {
    public:
     Client(int fd, const struct sockaddr& sockaddr);
@@ -22,9 +28,10 @@ class Client {
     int getFd() const;
 
     void setSendBuffer(const std::string& sendBuffer);
-    std::string& getSendBuffer();
+    std::string getSendBuffer() const;
+    SendQueue& getSendQueue();
     void setRecvBuffer(const std::string& recvBuffer);
-    std::string& getRecvBuffer();
+    RecvBuffer& getRecvBuffer();
 
     std::string getNickname() const;
     std::string getOldNickname() const;
@@ -32,6 +39,8 @@ class Client {
     void setUserName(const std::string& userName);
     void setPassword(const std::string& password);
     void appendToSendBuffer(const std::string& packet);
+    void appendToSendBuffer(const SharedPayload& payload);
+    void appendToSendBuffer(const ReplyBuilder& reply);
     void appendToRecvBuffer(const std::string& packet);
     void clearSendBuffer();
     void clearRecvBuffer();
@@ -46,30 +55,55 @@ class Client {
     void setDisconnectReason(const std::string& reason);
     std::string getDisconnectErrorReason() const;
     void setDisconnectErrorReason(const std::string& reason);
-    void recordMyChannel(std::string& channel);
-    void unrecordMyChannel(std::string& channel);
-    std::vector<std::string>& getMyChannels();
+    void recordMyChannel(Channel* channel);
+    void unrecordMyChannel(Channel* channel);
+    const std::vector<Channel*>& getMyChannels() const;
     std::string& getHost();
+    const std::string& getPrefix();
     void processErrorMessage();
-    bool isMemberOfChannel(const std::string& channelName);
+    bool isMemberOfChannel(const Channel* channel) const;
+    void setPendingWriteQueue(std::vector<int>* pendingWriteQueue);
+    void setClientTable(ClientTable* clientTable);
+    void unschedulePendingWrite();
+    void deferReplies();
+    void mergeDeferredReplies();
+    bool isWriteInterestArmed() const;
+    void setWriteInterestArmed(bool isArmed);
+    bool markFanout(unsigned long epoch);
 
    private:
     void setOldNickname_(const std::string& oldNickname);
     void populateIpAddr_();
+    void schedulePendingWrite_();
+    bool isDeferringReplies_() const;
     int fd_;
     struct sockaddr sockaddr_;
 
     std::string nickname_;
     std::string oldNickname_;
     std::string userName_;
-    std::string sendBuffer_;
-    std::string recvBuffer_;
+    SendQueue sendQueue_;
+    SendQueue deferredReplies_;  // replies of sender-only commands run without the state mutex, see deferReplies()
+    RecvBuffer recvBuffer_;
     std::string password_;
     std::string disconnectReason_;
     std::string disconnectErrorReason_;
     std::string ipAddr_;
+    std::string prefix_;  // ":nick!user@host" once rendered by getPrefix(), cleared when the nickname or username changes
+
+    // The channels the client joined, which stay at their address in the ChannelTable until erased
+    std::vector<Channel*> myChannels_;
+
+    // The table the client is stored in, its nickname index is updated by setNickname()
+    ClientTable* clientTable_;
+
+    // Server owned queue of fds with fresh data in their sendQueue_, see schedulePendingWrite_()
+    std::vector<int>* pendingWriteQueue_;
+    bool isWriteScheduled_;
+    bool isWriteInterestArmed_;
 
-    std::vector<std::string> myChannelsByName_;
+    // The last channel fanout that reached the client, see Channel::sendMessageToNeighbours()
+    unsigned long fanoutEpoch_;
 
     struct ClientStatus {
         bool gotUser;
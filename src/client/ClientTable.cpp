@@ -0,0 +1,126 @@
+#include "ClientTable.h"
+
+namespace irc {
+
+ClientTable::ClientTable() {}
+
+/**
+ * @brief Creates a table holding copies of the given clients at the given fds.
+ */
+ClientTable::ClientTable(std::initializer_list<std::pair<int, Client>> clients) {
+    for (const std::pair<int, Client>& client : clients) {
+        insert(client.first, client.second);
+    }
+}
+
+ClientTable::~ClientTable() {}
+
+/**
+ * @brief Stores a copy of client at fd.
+ *
+ * @return Client* The stored client, or nullptr if fd is negative or already taken.
+ */
+Client* ClientTable::insert(int fd, const Client& client) {
+    if (fd < 0 || getOrNull(fd) != nullptr) {
+        LOG_WARNING("ClientTable::insert: fd " << fd << " is invalid or already taken");
+        return nullptr;
+    }
+    unsigned long index = static_cast<unsigned long>(fd);
+    if (index >= slots_.size()) {
+        slots_.resize(index + 1);
+    }
+    slots_[index].client.reset(new Client(client));
+    slots_[index].position = live_.size();
+    Client* stored = slots_[index].client.get();
+    live_.push_back(stored);
+    liveFds_.push_back(fd);
+    stored->setClientTable(this);
+    if (stored->isGotNick()) {
+        reindexNickname(*stored, nullptr);
+    }
+    return stored;
+}
+
+Client* ClientTable::getOrNull(int fd) const {
+    if (fd < 0 || static_cast<unsigned long>(fd) >= slots_.size()) {
+        return nullptr;
+    }
+    return slots_[static_cast<unsigned long>(fd)].client.get();
+}
+
+/**
+ * @brief Finds the client whose nickname equals nickname under IRC casemapping.
+ *
+ * @return Client* The client, or nullptr if no client uses the nickname.
+ */
+Client* ClientTable::getByNicknameOrNull(const std::string& nickname) const {
+    std::unordered_map<std::string, Client*>::const_iterator it = byNickname_.find(casefold(nickname));
+    if (it == byNickname_.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Indexes client under its current nickname, called by Client::setNickname().
+ *
+ * A copy of a stored client, which is not at its fd in this table, is ignored.
+ *
+ * @param client The client whose nickname was set.
+ * @param previousNickname The nickname it was indexed under before, nullptr if it had none.
+ */
+void ClientTable::reindexNickname(Client& client, const std::string* previousNickname) {
+    if (getOrNull(client.getFd()) != &client) {
+        return;
+    }
+    if (previousNickname != nullptr) {
+        std::unordered_map<std::string, Client*>::iterator it = byNickname_.find(casefold(*previousNickname));
+        if (it != byNickname_.end() && it->second == &client) {
+            byNickname_.erase(it);
+        }
+    }
+    byNickname_[casefold(client.getNickname())] = &client;
+}
+
+/**
+ * @brief Destroys the client at fd, the last live client takes its place in the iteration order.
+ *
+ * @return int SUCCESS if a client was erased, FAILURE if there was none at fd.
+ */
+int ClientTable::erase(int fd) {
+    if (getOrNull(fd) == nullptr) {
+        return FAILURE;
+    }
+    Slot& slot = slots_[static_cast<unsigned long>(fd)];
+    if (slot.client->isGotNick()) {
+        std::unordered_map<std::string, Client*>::iterator it = byNickname_.find(casefold(slot.client->getNickname()));
+        if (it != byNickname_.end() && it->second == slot.client.get()) {
+            byNickname_.erase(it);
+        }
+    }
+    live_[slot.position] = live_.back();
+    liveFds_[slot.position] = liveFds_.back();
+    slots_[static_cast<unsigned long>(liveFds_[slot.position])].position = slot.position;
+    live_.pop_back();
+    liveFds_.pop_back();
+    slot.client.reset();
+    return SUCCESS;
+}
+
+unsigned long ClientTable::size() const {
+    return live_.size();
+}
+
+bool ClientTable::empty() const {
+    return live_.empty();
+}
+
+ClientTable::const_iterator ClientTable::begin() const {
+    return live_.begin();
+}
+
+ClientTable::const_iterator ClientTable::end() const {
+    return live_.end();
+}
+
+}  // namespace irc
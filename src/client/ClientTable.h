@@ -0,0 +1,63 @@
+#ifndef CLIENTTABLE_H
+#define CLIENTTABLE_H
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../common/casefold.h"
+#include "Client.h"
+
+namespace irc {
+
+/**
+ * @class ClientTable
+ * @brief The connected clients, indexed by their (small, dense) file descriptor.
+ *
+ * Looking a client up is a bounds check and an array access instead of a tree walk.
+ * Every client lives in its own heap block, so the Client* held by channels stay valid
+ * until the client is erased. A second, dense array of the live clients makes iterating
+ * proportional to the amount of clients instead of the highest fd.
+ *
+ * The clients that have a nickname are also indexed by its casefolded form. A stored client
+ * knows its table and keeps the index up to date from Client::setNickname(), erase() drops it.
+ */
+class ClientTable {
+   public:
+    typedef std::vector<Client*>::const_iterator const_iterator;
+
+    ClientTable();
+    ClientTable(std::initializer_list<std::pair<int, Client>> clients);
+    ~ClientTable();
+
+    Client* insert(int fd, const Client& client);
+    Client* getOrNull(int fd) const;
+    Client* getByNicknameOrNull(const std::string& nickname) const;
+    void reindexNickname(Client& client, const std::string* previousNickname);
+    int erase(int fd);
+    unsigned long size() const;
+    bool empty() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+
+   private:
+    ClientTable(const ClientTable& other);
+    ClientTable& operator=(const ClientTable& other);
+
+    struct Slot {
+        std::unique_ptr<Client> client;
+        unsigned long position;  // index of the client in live_
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<Client*> live_;
+    std::vector<int> liveFds_;  // the fd of every client in live_, at the same position
+    std::unordered_map<std::string, Client*> byNickname_;  // keyed by the casefolded nickname
+};
+
+}  // namespace irc
+
+#endif
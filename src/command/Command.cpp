@@ -2,64 +2,43 @@
 
 namespace irc {
 
-std::map<std::string, std::function<void(Command*, Client&)>> Command::commands = {{"PING",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionPing(client);
-                                                                                    }},
-                                                                                   {"CHANNEL",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionChannel(client);
-                                                                                    }},
-                                                                                   {"PART",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionPart(client);
-                                                                                    }},
-                                                                                   {"PASS",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionPass(client);
-                                                                                    }},
-                                                                                   {"NICK",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionNick(client);
-                                                                                    }},
-                                                                                   {"USER",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionUser(client);
-                                                                                    }},
-                                                                                   {"QUIT",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionQuit(client);
-                                                                                    }},
-                                                                                   {"PRIVMSG",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionPrivmsg(client);
-                                                                                    }},
-                                                                                   {"JOIN",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionJoin(client);
-                                                                                    }},
-                                                                                   {"TOPIC",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionTopic(client);
-                                                                                    }},
-                                                                                   {"KICK",
-                                                                                    [](Command* cmd, Client& client) {
-                                                                                        cmd->actionKick(client);
-                                                                                    }},
-                                                                                   {"MODE", [](Command* cmd, Client& client) {
-                                                                                        cmd->actionMode(client);
-                                                                                    }},
-                                                                                   {"INVITE", [](Command* cmd, Client& client) {
-                                                                                        cmd->actionInvite(client);
-                                                                                    }}};
-
-Command::Command(const Message& commandString, Client& client, std::map<int, Client>& allClients, std::string& password,
-                 time_t& serverStartTime, std::map<std::string, Channel>& allChannels)
-    : client_(client), allClients_(allClients), allChannels_(allChannels), pass_(password), serverStartTime_(serverStartTime) {
-    numeric_ = 0;
-    commandName_ = commandString.getCommand();
-    prefix_ = commandString.getPrefix();
-    param_ = commandString.getParameters();
+/**
+ * @brief What to do for each CommandId, indexed by it.
+ *
+ * A command without an action is answered with ERR_UNKNOWNCOMMAND once the client is registered.
+ * Before that, only the commands allowed before registration are executed (CAP is ignored),
+ * every other command is answered with ERR_NOTREGISTERED.
+ * Only the actions that copy the parameters get them as std::string in param_, the others
+ * (PRIVMSG, PING) read views of message_, so relaying a message does not copy its text.
+ * The sender-only actions read and write nothing but the fields and replies of the sender.
+ */
+const Command::Action Command::actions_[COMMAND_COUNT] = {
+    {NULL, false, false, true},                      // COMMAND_UNKNOWN
+    {NULL, true, false, true},                       // COMMAND_CAP
+    {&Command::actionChannel, false, true, true},    // COMMAND_CHANNEL
+    {&Command::actionInvite, false, true, false},    // COMMAND_INVITE
+    {&Command::actionJoin, false, true, false},      // COMMAND_JOIN
+    {&Command::actionKick, false, true, false},      // COMMAND_KICK
+    {&Command::actionMode, false, true, false},      // COMMAND_MODE
+    {&Command::actionNick, true, true, false},       // COMMAND_NICK
+    {&Command::actionPart, false, true, false},      // COMMAND_PART
+    {&Command::actionPass, true, true, true},        // COMMAND_PASS
+    {&Command::actionPing, false, false, true},      // COMMAND_PING
+    {&Command::actionPrivmsg, false, false, false},  // COMMAND_PRIVMSG
+    {&Command::actionQuit, false, true, true},       // COMMAND_QUIT
+    {&Command::actionTopic, false, true, false},     // COMMAND_TOPIC
+    {&Command::actionUser, true, true, true},        // COMMAND_USER
+};
+
+Command::Command(const Message& commandString, Client& client, ClientTable& allClients, std::string& password,
+                 time_t& serverStartTime, ChannelTable& allChannels)
+    : message_(commandString),
+      client_(client),
+      allClients_(allClients),
+      allChannels_(allChannels),
+      pass_(password),
+      serverStartTime_(serverStartTime) {
+    commandId_ = commandString.getCommandId();
     numeric_ = commandString.getNumeric();
     if (serverStartTime <= 0) {
         throw std::invalid_argument("Command::Command: Invalid server start time");
@@ -73,38 +52,49 @@ Command::Command(const Message& commandString, Client& client, std::map<int, Cli
 Command::~Command() {}
 
 void Command::execute(Client& client) {
+    const Action& action = actions_[commandId_];
+    if (action.copiesParameters && param_.empty()) {
+        param_ = message_.getParameters();
+    }
     if (client.isAuthenticated()) {
-        auto it = commands.find(commandName_);
-        if (it != commands.end()) {
-            it->second(this, client);
+        if (action.handler != NULL) {
+            (this->*action.handler)(client);
         } else {
-            client.appendToSendBuffer(RPL_ERR_UNKNOWNCOMMAND_421(serverHostname_g, commandName_));
-            LOG_DEBUG("Command::execute: command not found: " << commandName_);
+            client.appendToSendBuffer(RPL_ERR_UNKNOWNCOMMAND_421(serverHostname_g, message_.getCommand()));
+            LOG_DEBUG("Command::execute: command not found: " << message_.getCommand());
         }
         return;
     }
 
-    if (commandName_ == "NICK" || commandName_ == "USER" || commandName_ == "PASS") {
-        auto it = commands.find(commandName_);
-        if (it != commands.end()) {
-            it->second(this, client);
+    if (action.allowedBeforeRegistration) {
+        if (action.handler != NULL) {
+            (this->*action.handler)(client);
         } else {
-            LOG_WARNING("Command::execute: NICK|USER|PASS command not found: " << commandName_);
+            LOG_DEBUG("Command::execute: " << message_.getCommand() << " command received, ignoring");
         }
         return;
     }
 
-    if (commandName_ == "CAP") {
-        LOG_DEBUG("Command::execute: CAP command received, ignoring");
-        return;
-    }
-
     // If the client is sending a command before being authenticated
     client.appendToSendBuffer(RPL_ERR_NOTREGISTERED_451(serverHostname_g));
 }
 
+/**
+ * @brief Whether executing message only touches the client that sent it, its own fields and replies.
+ *
+ * Only the reactor owning the client writes those fields, so it runs such commands without the
+ * server state mutex. Every command refused with ERR_NOTREGISTERED is one of them.
+ */
+bool Command::isSenderOnly(const Message& message, Client& client) {
+    const Action& action = actions_[message.getCommandId()];
+    if (client.isAuthenticated() == false && action.allowedBeforeRegistration == false) {
+        return true;
+    }
+    return action.isSenderOnly;
+}
+
 void Command::actionPing(Client& client) {
-    client.appendToSendBuffer(RPL_MESSAGE("PONG " + serverHostname_g));
+    client.appendToSendBuffer(RPL_MESSAGE("PONG ", serverHostname_g));
 }
 
 void Command::actionPass(Client& client) {
@@ -156,14 +146,14 @@ void Command::actionNick(Client& client) {
         return;
     }
 
-    try {
-        (void)findClientByNicknameOrThrow(desiredNickname);
+    if (findClientByNicknameOrNull_(desiredNickname) != nullptr) {
         client.appendToSendBuffer(RPL_ERR_NICKNAMEINUSE_433(serverHostname_g, client.getNickname(), desiredNickname));
         return;
-    } catch (std::out_of_range& e) {
-        ;  // The nickname is not in use
     }
     client.setNickname(desiredNickname);
+    for (Channel* channel : client.getMyChannels()) {
+        channel->refreshMemberName(client);
+    }
     if (isAlreadyAuthenticated == false && client.isAuthenticated()) {
         sendAuthReplies_(client);
         return;  // Early return to avoid sending the NICK message for a just authenticated client IRCv3
@@ -173,15 +163,11 @@ void Command::actionNick(Client& client) {
     std::string nickMessage = COM_MESSAGE(client.getOldNickname(), client.getUserName(), client.getHost(), "NICK", client.getNickname());
     client.appendToSendBuffer(nickMessage);
 
-    // Send the NICK message to all shared channels (do not resend to client)
-    std::vector<std::string> channelNames = client.getMyChannels();
-    if (channelNames.size() == 0) {
+    // Send the NICK message once to everyone sharing a channel with the client (do not resend to client)
+    if (client.getMyChannels().size() == 0) {
         return;
     }
-    for (std::string channelName : channelNames) {
-        Channel& channel = allChannels_.at(channelName);
-        channel.sendMessageToMembersExcluding(nickMessage, client);
-    }
+    Channel::sendMessageToNeighbours(client, std::make_shared<const std::string>(nickMessage));
 }
 
 void Command::actionUser(Client& client) {
@@ -217,17 +203,15 @@ void Command::actionInvite(Client& client) {
     }
     std::string nickname = param_.at(0);
     std::string channelName = param_.at(1);
-    try {
-        (void)findClientByNicknameOrThrow(nickname);
-    } catch (std::out_of_range& e) {
+    Client* inviteeOrNull = findClientByNicknameOrNull_(nickname);
+    if (inviteeOrNull == nullptr) {
         client.appendToSendBuffer(RPL_ERR_NOSUCHNICK_401(serverHostname_g, nickname));
         return;
     }
-    //it means that the nick exits
-    Client& invitee = findClientByNicknameOrThrow(nickname);
-    auto it = allChannels_.find(channelName);
-    if (it != allChannels_.end()) {
-        Channel& channel = allChannels_.at(channelName);
+    Client& invitee = *inviteeOrNull;
+    Channel* channelOrNull = findChannelOrNull_(channelName);
+    if (channelOrNull != nullptr) {
+        Channel& channel = *channelOrNull;
         if (!channel.isMember(client)) {
             client.appendToSendBuffer(RPL_ERR_NOTONCHANNEL_442(serverHostname_g, client.getNickname(), channelName));
             return;
@@ -247,7 +231,7 @@ void Command::actionInvite(Client& client) {
         }
     }
     client.appendToSendBuffer(RPL_INVITING_341(serverHostname_g, client.getNickname(), nickname, channelName));
-    invitee.appendToSendBuffer(INVITE(client.getNickname(), client.getUserName(), client.getHost(), nickname, channelName));
+    invitee.appendToSendBuffer(INVITE_FROM(client.getPrefix(), nickname, channelName));
 }
 
 void Command::actionPart(Client& client) {
@@ -274,19 +258,19 @@ void Command::actionPart(Client& client) {
     // Part the channels one by one
     for (std::string channelName : channelsToPart) {
 
-        if (allChannels_.find(channelName) == allChannels_.end()) {
+        Channel* channelOrNull = findChannelOrNull_(channelName);
+        if (channelOrNull == nullptr) {
             client.appendToSendBuffer(RPL_ERR_NOSUCHCHANNEL_403(serverHostname_g, channelName));
             continue;
         }
 
-        Channel& currentChannel = allChannels_.at(channelName);
+        Channel& currentChannel = *channelOrNull;
         if (currentChannel.isMember(client) == false) {
             client.appendToSendBuffer(RPL_ERR_NOTONCHANNEL_442(serverHostname_g, client.getNickname(), channelName));
             continue;
         }
 
-        currentChannel.sendMessageToMembers(COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "PART",
-                                                        currentChannel.getName() + " :" + partMessage));
+        currentChannel.sendMessageToMembers(PREFIXED_MESSAGE(client.getPrefix(), "PART", currentChannel.getName(), " :", partMessage));
         currentChannel.partMember(client);
     }
 }
@@ -315,17 +299,16 @@ void Command::actionTopic(Client& client) {
         }
     }
 
-    // validate client
-    bool isMember = client.isMemberOfChannel(param_.at(0));
-
-    // validate channel if client is not a member (if client is a member, channel is already validated)
-    if (!isMember && (allChannels_.find(param_.at(0)) == allChannels_.end())) {
+    // validate channel
+    Channel* channelOrNull = findChannelOrNull_(param_.at(0));
+    if (channelOrNull == nullptr) {
         client.appendToSendBuffer(RPL_ERR_NOSUCHCHANNEL_403(serverHostname_g, param_.at(0)));
         return;
     }
 
     // at this point, the channel exists
-    Channel& channel = allChannels_.at(param_.at(0));
+    Channel& channel = *channelOrNull;
+    bool isMember = channel.isMember(client);
 
     // get the topic
     if (param_.size() == 1) {
@@ -353,8 +336,7 @@ void Command::actionTopic(Client& client) {
     channel.setTopic(topicParam);
 
     // send the topic to all members, should the client be exluded and rpl_topic_332 be sent? TODO
-    channel.sendMessageToMembers(
-        COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "TOPIC", channel.getName() + " :" + topicParam));
+    channel.sendMessageToMembers(PREFIXED_MESSAGE(client.getPrefix(), "TOPIC", channel.getName(), " :", topicParam));
 }
 
 /**
@@ -387,40 +369,27 @@ void Command::actionQuit(Client& client) {
 }
 
 /**
- * @brief Finds a client by their nickname, throwing an exception if not found.
+ * @brief Finds a client by their nickname.
  *
- * This function searches for a client with the specified nickname. It converts the
- * nickname and the client nicknames to lowercase and replaces certain characters to
- * match the IRC specification. If the client is found, it returns a reference to the
- * client. If not, it throws an std::out_of_range exception.
+ * The nickname is compared under IRC casemapping through the nickname index of the
+ * client table. A miss is an ordinary outcome (a free nickname, an unknown target),
+ * so it is reported with a null pointer rather than an exception.
  *
  * @param  The nickname to search for.
- * @return A reference to the client with the matching nickname.
- * @throws std::out_of_range if the client is not found.
+ * @return The client with the matching nickname, or nullptr if there is none.
  */
-Client& Command::findClientByNicknameOrThrow(const std::string& nickname) {
-    std::string lowerNickname = nickname;  //here we just put everything in lowercase
-    std::transform(lowerNickname.begin(), lowerNickname.end(), lowerNickname.begin(), ::tolower);
-    std::replace(lowerNickname.begin(), lowerNickname.end(), '{', '[');
-    std::replace(lowerNickname.begin(), lowerNickname.end(), '}', ']');
-    std::replace(lowerNickname.begin(), lowerNickname.end(), '|', '\\');
-    std::replace(lowerNickname.begin(), lowerNickname.end(), '^', '~');
-
-    for (std::map<int, Client>::const_iterator it = allClients_.begin(); it != allClients_.end(); ++it) {
-        std::string clientNickname = it->second.getNickname();  //here we just put everything in lowercase
-        std::transform(clientNickname.begin(), clientNickname.end(), clientNickname.begin(), ::tolower);
-        std::replace(clientNickname.begin(), clientNickname.end(), '{', '[');
-        std::replace(clientNickname.begin(), clientNickname.end(), '}', ']');
-        std::replace(clientNickname.begin(), clientNickname.end(), '|', '\\');
-        std::replace(clientNickname.begin(), clientNickname.end(), '^', '~');
-        if (clientNickname == lowerNickname) {
-            LOG_DEBUG("CMD::findClientByNickname: Found client with the same nickname: " << nickname);
-            return allClients_.at(it->first);
-        }
-    }
+Client* Command::findClientByNicknameOrNull_(const std::string& nickname) const {
+    return allClients_.getByNicknameOrNull(nickname);
+}
 
-    LOG_DEBUG(std::string("Command::findClientByNicknameOrThrow: ") + nickname + " not found");
-    throw std::out_of_range(std::string("Command::findClientByNicknameOrThrow: ") + nickname + " not found");
+/**
+ * @brief Finds a channel by its name, compared under IRC casemapping.
+ *
+ * @param  The channel name to search for.
+ * @return The channel with the matching name, or nullptr if there is none.
+ */
+Channel* Command::findChannelOrNull_(const std::string& channelName) const {
+    return allChannels_.getOrNull(channelName);
 }
 
 /**
@@ -440,12 +409,7 @@ Client& Command::findClientByNicknameOrThrow(const std::string& nickname) {
  *   @return true if the nickname is valid, false otherwise.
  */
 bool Command::isValidNickname(std::string& nickname) {
-    std::regex pattern(R"(^[a-zA-Z\[\]\\`_^{|}])");
-    std::regex pattern1(R"(^[a-zA-Z0-9\[\]\\`_^{|}-]*$)");
-    if (!std::regex_match(nickname.substr(0, 1), pattern)) {
-        return false;
-    }
-    if (!std::regex_match(nickname, pattern1)) {
+    if (!matchesNicknamePattern(nickname.data(), nickname.size())) {
         return false;
     }
     if (nickname.size() > NICK_MAX_LENGTH_RFC2812) {
@@ -459,7 +423,8 @@ void Command::sendAuthReplies_(Client& client) {
     std::string clientNick = client.getNickname();
     client.appendToSendBuffer(RPL_WELCOME_001(serverHostname_g, clientNick, client.getUserName(), client.getHost()));
     client.appendToSendBuffer(RPL_YOURHOST_002(serverHostname_g, clientNick, IRC_SERVER_VERSION));
-    std::string time = std::string(ctime(&serverStartTime_));
+    char rendered[26];  // ctime_r() writes at most 26 bytes, it is used as ctime() is not safe with several workers
+    std::string time = std::string(ctime_r(&serverStartTime_, rendered));
     time.pop_back();  // Remove the newline character
     client.appendToSendBuffer(RPL_CREATED_003(serverHostname_g, clientNick, time));
     client.appendToSendBuffer(
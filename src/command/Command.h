@@ -2,16 +2,16 @@
 #define COMMAND_H
 
 #include <cctype>
-#include <functional>
 #include <iostream>
-#include <map>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "../channel/Channel.h"
+#include "../channel/ChannelTable.h"
 #include "../client/Client.h"
+#include "../client/ClientTable.h"
+#include "../common/charclass.h"
 #include "../common/log.h"
 #include "../common/magicNumber.h"
 #include "../common/reply.h"
@@ -25,9 +25,10 @@ namespace irc {
 
 class Command {
    public:
-    Command(const Message& commandString, Client& client, std::map<int, Client>& allClients, std::string& password, time_t& serverStartTime,
-            std::map<std::string, Channel>& allChannels);
+    Command(const Message& commandString, Client& client, ClientTable& allClients, std::string& password, time_t& serverStartTime,
+            ChannelTable& allChannels);
     void execute(Client& client);
+    static bool isSenderOnly(const Message& message, Client& client);
     void actionPing(Client& client);
     void actionChannel(Client& client);
     void actionKick(Client& client);
@@ -44,19 +45,26 @@ class Command {
     ~Command();
 
    private:
-    std::string prefix_;
-    std::string commandName_;
-    std::vector<std::string> param_;
+    const Message& message_;  // executed in the constructor, so it outlives every action
+    CommandId commandId_;
+    std::vector<std::string> param_;  // copies of the parameters, only made for the actions that use them
     int numeric_;
     Client& client_;
-    std::map<int, Client>& allClients_;
-    std::map<std::string, Channel>& allChannels_;
+    ClientTable& allClients_;
+    ChannelTable& allChannels_;
     std::string& pass_;
     time_t serverStartTime_;
 
-    Client& findClientByNicknameOrThrow(const std::string& nickname);
+    Client* findClientByNicknameOrNull_(const std::string& nickname) const;
+    Channel* findChannelOrNull_(const std::string& channelName) const;
     void sendAuthReplies_(Client& client);
-    static std::map<std::string, std::function<void(Command*, Client&)>> commands;
+    struct Action {
+        void (Command::*handler)(Client& client);
+        bool allowedBeforeRegistration;
+        bool copiesParameters;  // false for the actions that read message_ views instead of param_
+        bool isSenderOnly;      // true for the actions that only touch the client that sent the command
+    };
+    static const Action actions_[COMMAND_COUNT];
     bool isValidNickname(std::string& nickname);
 
     // PRIVMSG
@@ -10,27 +10,18 @@ void Command::actionJoin(Client& client) {
     }
     // Leave all channels
     if (param_.size() == 1 && param_.at(0) == "0") {
-        std::vector<std::string> myChannels = client.getMyChannels();
-        for (std::string channelName : myChannels) {
-            if (allChannels_.find(channelName) == allChannels_.end()) {
-                LOG_ERROR(
-                    "Command::actionJoin: Channel object not found using client's "
-                    "channel list"
-                    << client.getNickname() << " " << channelName)
-                continue;
-            }
-
-            Channel& currentChannel = allChannels_.at(channelName);
+        std::vector<Channel*> myChannels = client.getMyChannels();  // parting changes the client's list
+        for (Channel* channel : myChannels) {
+            Channel& currentChannel = *channel;
             if (currentChannel.isMember(client) == false) {
                 LOG_ERROR(
                     "Command::actionJoin: Client is not a member of the channel that "
                     "is in its channel list"
-                    << client.getNickname() << " " << channelName)
+                    << client.getNickname() << " " << currentChannel.getName())
                 continue;
             }
 
-            currentChannel.sendMessageToMembers(
-                COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "PART", client.getNickname()));
+            currentChannel.sendMessageToMembers(PREFIXED_MESSAGE(client.getPrefix(), "PART", client.getNickname()));
             currentChannel.partMember(client);
         }
         return;
@@ -62,7 +53,8 @@ void Command::actionJoin(Client& client) {
         std::string channelName = rit->first;
         std::string channelKey = rit->second;
 
-        if (client.isMemberOfChannel(channelName)) {
+        Channel* channelOrNull = findChannelOrNull_(channelName);
+        if (channelOrNull != nullptr && channelOrNull->isMember(client)) {
             continue;
         }
 
@@ -76,8 +68,8 @@ void Command::actionJoin(Client& client) {
             continue;
         }
 
-        if (Channel::isChannelNameFree(channelName, allChannels_) == false) {
-            Channel& existingChannel = allChannels_.at(channelName);
+        if (channelOrNull != nullptr) {
+            Channel& existingChannel = *channelOrNull;
             if (channelKey != existingChannel.getKey()) {
                 client.appendToSendBuffer(RPL_ERR_BADCHANNELKEY_475(serverHostname_g, client.getNickname(), channelName));
                 continue;
@@ -93,12 +85,17 @@ void Command::actionJoin(Client& client) {
             }
             existingChannel.joinMember(client);
         } else {
-            allChannels_.insert(std::make_pair(channelName, Channel(client, channelName, allChannels_)));
+            channelOrNull = allChannels_.insert(client, channelName);
+            if (channelOrNull == nullptr) {
+                client.appendToSendBuffer(RPL_ERR_NOSUCHCHANNEL_403(serverHostname_g, channelName));
+                continue;
+            }
         }
 
-        Channel& currentChannel = allChannels_.at(channelName);
+        Channel& currentChannel = *channelOrNull;
+        channelName = currentChannel.getName();  // the spelling the channel was created with
         // Join message for the channel, and as a reply to the client
-        currentChannel.sendMessageToMembers(COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "JOIN", channelName));
+        currentChannel.sendMessageToMembers(PREFIXED_MESSAGE(client.getPrefix(), "JOIN", channelName));
 
         if (currentChannel.getTopic() != "") {
             client.appendToSendBuffer(
@@ -107,8 +104,12 @@ void Command::actionJoin(Client& client) {
             client.appendToSendBuffer(RPL_NOTOPIC_331(serverHostname_g, client.getNickname(), channelName));
         }
 
-        client.appendToSendBuffer(
-            RPL_NAMREPLY_353(serverHostname_g, client.getNickname(), CHANNEL_SYMBOL_PUBLIC, channelName, currentChannel.getNamesList()));
+        for (const std::string& namesLine : currentChannel.getNamesLines()) {
+            if (namesLine.empty() == false) {
+                client.appendToSendBuffer(RPL_NAMREPLY_353(serverHostname_g, client.getNickname(), CHANNEL_SYMBOL_PUBLIC, channelName, namesLine));
+            }
+        }
+        client.appendToSendBuffer(RPL_ENDOFNAMES_366(serverHostname_g, client.getNickname(), channelName));
     }  // for (rit = rChannelKeyPairs.begin(); rit != rChannelKeyPairs.end(); rit++)
 }
 
@@ -31,28 +31,18 @@ void Command::actionKick(Client& client) {
     }
 
     // validate client and channel
-    std::vector<std::string> clientChannels = client.getMyChannels();
-    bool isMember = false;
-    for (std::string clientChannel : clientChannels) {
-        if (clientChannel == param_.at(0)) {
-            isMember = true;
-            break;
-        }
+    Channel* channelOrNull = findChannelOrNull_(param_.at(0));
+    if (channelOrNull == nullptr) {
+        client.appendToSendBuffer(RPL_ERR_NOSUCHCHANNEL_403(serverHostname_g, param_.at(0)));
+        return;
     }
-    if (isMember == false) {
-        try {
-            Channel& channel = allChannels_.at(param_.at(0));
-            (void)channel;  // suppress warning about unused variable
-            client.appendToSendBuffer(RPL_ERR_NOTONCHANNEL_442(serverHostname_g, client.getNickname(), param_.at(0)));
-            return;
-        } catch (std::out_of_range& e) {
-            client.appendToSendBuffer(RPL_ERR_NOSUCHCHANNEL_403(serverHostname_g, param_.at(0)));
-            return;
-        }
+    Channel& channel = *channelOrNull;
+    if (channel.isMember(client) == false) {
+        client.appendToSendBuffer(RPL_ERR_NOTONCHANNEL_442(serverHostname_g, client.getNickname(), param_.at(0)));
+        return;
     }
     // at this point we know the channel exists and the client is member
 
-    Channel& channel = allChannels_.at(param_.at(0));
     if (channel.isOperator(client) == false) {
         client.appendToSendBuffer(RPL_ERR_CHANOPRIVSNEEDED_482(serverHostname_g, client.getNickname(), param_.at(0)));
         return;
@@ -63,30 +53,21 @@ void Command::actionKick(Client& client) {
     // Now we check if the clients they are trying to kick exist.
     std::vector<std::string> clientsToKick = parseKick(param_.at(1));
     for (const std::string& clientNickToKick : clientsToKick) {
-        try {
-            (void)findClientByNicknameOrThrow(clientNickToKick);
-        } catch (std::out_of_range& e) {
+        Client* clientToKickOrNull = findClientByNicknameOrNull_(clientNickToKick);
+        if (clientToKickOrNull == nullptr) {
             client.appendToSendBuffer(RPL_ERR_NOSUCHNICK_401(serverHostname_g, clientNickToKick));
             return;
         }
         // At this point we know the client nick to be kicked exists.
-        Client& clientToKick = findClientByNicknameOrThrow(clientNickToKick);
+        Client& clientToKick = *clientToKickOrNull;
         // Here we check if he belongs to that channel.
-        clientChannels = clientToKick.getMyChannels();
-        isMember = false;
-        for (std::string clientChannel : clientChannels) {
-            if (clientChannel == param_.at(0)) {
-                isMember = true;
-                break;
-            }
-        }
-        if (isMember == false) {
+        if (channel.isMember(clientToKick) == false) {
             client.appendToSendBuffer(RPL_ERR_USERNOTINCHANNEL_441(serverHostname_g, clientNickToKick, param_.at(0)));
             return;
         }
         // supposed to send: :nick!user@host KICK #channel nicktokick :reason
-        channel.sendMessageToMembers(COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "KICK",
-                                                 channel.getName() + " " + clientToKick.getNickname() + " :" + reasonToKick));
+        channel.sendMessageToMembers(
+            PREFIXED_MESSAGE(client.getPrefix(), "KICK", channel.getName(), " ", clientToKick.getNickname(), " :", reasonToKick));
         channel.partMember(clientToKick);
     }
 }
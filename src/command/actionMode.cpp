@@ -52,27 +52,18 @@ void Command::actionMode(Client& client) {
     }
 
     // Check if the channel exists
-    try {
-        Channel& channel = allChannels_.at(param_.at(0));
-        (void)channel;  // suppress unused variable warning
-    } catch (const std::out_of_range& e) {
+    Channel* channelOrNull = findChannelOrNull_(param_.at(0));
+    if (channelOrNull == nullptr) {
         LOG_DEBUG("Command::actionMode: channel does not exist");
         client.appendToSendBuffer(RPL_ERR_NOSUCHCHANNEL_403(serverHostname_g, param_.at(0)));
         return;
     }
 
     // We know that the channel exists
-    Channel& channel = allChannels_.at(param_.at(0));
+    Channel& channel = *channelOrNull;
 
     // Save info about if the client is a member of the channel
-    std::vector<std::string> clientChannels = client.getMyChannels();
-    bool isMember = false;
-    for (std::string clientChannel : clientChannels) {
-        if (clientChannel == param_.at(0)) {
-            isMember = true;
-            break;
-        }
-    }
+    bool isMember = channel.isMember(client);
 
     // Get the modes and return if the channel is the only parameter
     std::string enabledModesString;
@@ -142,7 +133,7 @@ void Command::actionMode(Client& client) {
         for (char mode : currentParamString) {
             if (isModeSupported(mode) == false) {
                 LOG_DEBUG("Command::actionMode: mode not supported: " << mode);
-                client.appendToSendBuffer(RPL_ERR_UNKNOWNMODE_472(serverHostname_g, client.getNickname(), mode, channel.getName()));
+                client.appendToSendBuffer(RPL_ERR_UNKNOWNMODE_472(serverHostname_g, client.getNickname(), std::string(1, mode), channel.getName()));
                 return;
             }
             currentMode.modifier = currentModifier;
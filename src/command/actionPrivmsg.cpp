@@ -2,16 +2,23 @@
 
 namespace irc {
 
+/**
+ * @brief Relays a message to a channel or a client.
+ *
+ * The parameters are read as views of the message: only the target is copied, to look it up,
+ * the text goes from the received line straight into the relayed one.
+ */
 void Command::actionPrivmsg(Client& client) {
-    size_t amountParameters = param_.size();
+    unsigned long amountParameters = message_.getParameterCount();
     if (amountParameters == 0) {
         client.appendToSendBuffer(RPL_ERR_NORECIPIENT_411(serverHostname_g, "privmsg"));
         LOG_DEBUG("CMD::PRIVMSG::NO RECIPIENT and NO MESSAGE");
         return;
     }
     if (amountParameters > 2) {
-        client.appendToSendBuffer(
-            RPL_ERR_TOOMANYTARGETS_407(serverHostname_g, param_.at(1), std::to_string(param_.size() - 1), "Only one target per message."));
+        Message::View secondParam = message_.getParameterView(1);
+        client.appendToSendBuffer(RPL_ERR_TOOMANYTARGETS_407(serverHostname_g, ReplyPart(secondParam.data, secondParam.length),
+                                                             std::to_string(amountParameters - 1), "Only one target per message."));
         LOG_DEBUG("CMD::PRIVMSG::TOO MANY TARGETS");
         return;
     }
@@ -22,51 +29,46 @@ void Command::actionPrivmsg(Client& client) {
     }
 
     // Now we know we have exactly 2 parameters
-    std::string targetParam = param_.at(0);
-    std::string messageParam = param_.at(1);
+    std::string targetParam = message_.getParameterView(0).toString();
+    Message::View messageParam = message_.getParameterView(1);
 
     // Required format: PRIVMSG <target> :<message> (checking the colon here)
-    if (messageParam.front() != ':') {
+    if (messageParam.length == 0 || messageParam.data[0] != ':') {
         client.appendToSendBuffer(RPL_ERR_NOTEXTTOSEND_412(serverHostname_g));
         LOG_DEBUG("CMD::PRIVMSG::NO TEXT (2nd param missing colon)");
         return;
     }
-    std::string messageParamWithoutColon = messageParam.erase(0, 1);
+    ReplyPart text(messageParam.data + 1, messageParam.length - 1);
 
     std::string channelPattern = CHANNEL_PREFIXES;
     if (channelPattern.find(targetParam.front()) != std::string::npos) {
         LOG_DEBUG("CMD::PRIVMSG: targetParam is a channel");
-        try {
-            Channel& channel = allChannels_.at(targetParam);
-            LOG_DEBUG("Command::actionPrivmsg: Channel found " + targetParam);
-            if (channel.isMember(client) == false) {
-                client.appendToSendBuffer(RPL_ERR_NOTONCHANNEL_442(serverHostname_g, client.getNickname(), targetParam));
-                return;
-            }
-            LOG_DEBUG("Command::actionPrivmsg: nick " + client.getNickname() + " is a member of " + targetParam);
-            channel.sendMessageToMembersExcluding(COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "PRIVMSG",
-                                                              targetParam + " :" + messageParamWithoutColon),
-                                                  client);
-        } catch (std::out_of_range& e) {
+        Channel* channel = findChannelOrNull_(targetParam);
+        if (channel == nullptr) {
             LOG_DEBUG("CMD::PRIVMSG::CHANNEL NOT FOUND");
             client.appendToSendBuffer(RPL_ERR_NOSUCHNICK_401(serverHostname_g, targetParam));
+            return;
         }
+        LOG_DEBUG("Command::actionPrivmsg: Channel found " + targetParam);
+        if (channel->isMember(client) == false) {
+            client.appendToSendBuffer(RPL_ERR_NOTONCHANNEL_442(serverHostname_g, client.getNickname(), channel->getName()));
+            return;
+        }
+        LOG_DEBUG("Command::actionPrivmsg: nick " + client.getNickname() + " is a member of " + targetParam);
+        channel->sendMessageToMembersExcluding(PREFIXED_MESSAGE(client.getPrefix(), "PRIVMSG", channel->getName(), " :", text), client);
         return;
     }
 
     LOG_DEBUG("CMD::PRIVMSG: targetParam is a user (nick)");
-    try {
-        Client& targetClient = findClientByNicknameOrThrow(targetParam);
-        LOG_DEBUG("CMD::PRIVMSG: Message is :" + messageParamWithoutColon + " from " + client.getNickname() + " to " + targetParam);
-
-        std::string formattedSender = FORMAT_NICK_USER_HOST(client.getNickname(), client.getUserName(), client.getHost());
-        std::string privmsg = PRIVMSG_FORMAT(formattedSender, targetParam, messageParamWithoutColon);
-        targetClient.appendToSendBuffer(privmsg);
-    } catch (std::out_of_range& e) {
+    Client* targetClient = findClientByNicknameOrNull_(targetParam);
+    if (targetClient == nullptr) {
         client.appendToSendBuffer(RPL_ERR_NOSUCHNICK_401(serverHostname_g, targetParam));
         LOG_DEBUG("CMD::PRIVMSG::findClientByNickname: USER NOT FOUND");
         return;
     }
+    LOG_DEBUG("CMD::PRIVMSG: Message is :" << messageParam.toString().substr(1) << " from " << client.getNickname() << " to " << targetParam);
+
+    targetClient->appendToSendBuffer(PRIVMSG_FORMAT(client.getPrefix(), targetParam, text));
 }
 
 }  // namespace irc
@@ -0,0 +1,65 @@
+#ifndef CASEFOLD_H
+#define CASEFOLD_H
+
+#include <string>
+
+namespace irc {
+
+/**
+ * @brief Folds one character the way IRC compares nicknames (RFC 1459 casemapping).
+ *
+ * ASCII letters are lowercased and "{}|^" are taken as the lowercase forms of "[]\~",
+ * so they fold to the same character.
+ */
+inline char casefoldChar(char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<char>(c - 'A' + 'a');
+    }
+    switch (c) {
+        case '{':
+            return '[';
+        case '}':
+            return ']';
+        case '|':
+            return '\\';
+        case '^':
+            return '~';
+        default:
+            return c;
+    }
+}
+
+/**
+ * @brief Folds name into folded, whose storage is reused. Two names are equal to IRC when their folds are.
+ */
+inline void casefold(const std::string& name, std::string& folded) {
+    folded.resize(name.size());
+    for (unsigned long i = 0; i < name.size(); i++) {
+        folded[i] = casefoldChar(name[i]);
+    }
+}
+
+inline std::string casefold(const std::string& name) {
+    std::string folded;
+    casefold(name, folded);
+    return folded;
+}
+
+/**
+ * @brief Compares two names under IRC casemapping without folding a copy of either.
+ */
+inline bool casefoldEquals(const std::string& left, const std::string& right) {
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (unsigned long i = 0; i < left.size(); i++) {
+        if (casefoldChar(left[i]) != casefoldChar(right[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace irc
+
+#endif
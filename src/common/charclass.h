@@ -0,0 +1,85 @@
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+namespace irc {
+
+/**
+ * @brief The character classes names are validated with, as bits of one table entry per byte.
+ */
+enum CharClass {
+    CHAR_NICKNAME_FIRST = 1,  // letter / special
+    CHAR_NICKNAME = 2,        // letter / digit / special / "-"
+    CHAR_CHANNEL_PREFIX = 4,  // "#" / "&"
+    CHAR_CHANNEL = 8,         // letter / digit / "_" / "-"
+};
+
+struct CharClassTable {
+    unsigned char classes[256];
+};
+
+/**
+ * @brief Builds the table at compile time, RFC 2812 special = %x5B-60 / %x7B-7D.
+ */
+constexpr CharClassTable makeCharClassTable() {
+    CharClassTable table = {};
+    for (int c = 0; c < 256; c++) {
+        bool isLetter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool isDigit = c >= '0' && c <= '9';
+        bool isSpecial = (c >= 0x5B && c <= 0x60) || (c >= 0x7B && c <= 0x7D);
+        int classes = 0;
+        if (isLetter || isSpecial) {
+            classes |= CHAR_NICKNAME_FIRST;
+        }
+        if (isLetter || isDigit || isSpecial || c == '-') {
+            classes |= CHAR_NICKNAME;
+        }
+        if (c == '#' || c == '&') {
+            classes |= CHAR_CHANNEL_PREFIX;
+        }
+        if (isLetter || isDigit || c == '_' || c == '-') {
+            classes |= CHAR_CHANNEL;
+        }
+        table.classes[c] = static_cast<unsigned char>(classes);
+    }
+    return table;
+}
+
+constexpr CharClassTable charClassTable = makeCharClassTable();
+
+inline bool hasCharClass(char c, CharClass charClass) {
+    return (charClassTable.classes[static_cast<unsigned char>(c)] & charClass) != 0;
+}
+
+/**
+ * @brief Matches ( letter / special ) *( letter / digit / special / "-" ), the length is not checked.
+ */
+inline bool matchesNicknamePattern(const char* name, unsigned long length) {
+    if (length == 0 || !hasCharClass(name[0], CHAR_NICKNAME_FIRST)) {
+        return false;
+    }
+    for (unsigned long i = 1; i < length; i++) {
+        if (!hasCharClass(name[i], CHAR_NICKNAME)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Matches ( "#" / "&" ) 1*( letter / digit / "_" / "-" ), the length is not checked.
+ */
+inline bool matchesChannelNamePattern(const char* name, unsigned long length) {
+    if (length < 2 || !hasCharClass(name[0], CHAR_CHANNEL_PREFIX)) {
+        return false;
+    }
+    for (unsigned long i = 1; i < length; i++) {
+        if (!hasCharClass(name[i], CHAR_CHANNEL)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace irc
+
+#endif
@@ -28,15 +28,38 @@
 #define BIND_FAILURE -1
 #define LISTEN_FAILURE -1
 #define ACCEPT_FAILURE -1
+#define GETPEERNAME_FAILURE -1
+#define SERVER_ACCEPT_BUDGET_PER_EVENT 256
 #define SEND_FAILURE -1
 #define RECV_FAILURE -1
 #define DEFAULT_SOCKET_PROTOCOL 0
 #define TCP_PROTOCOL 6
 #define POLL_FAILURE -1
+#define EPOLL_FAILURE -1
+#define EPOLL_MAX_EVENTS_PER_WAIT 1024
+#define POLLER_WAIT_INFINITE -1
+#define POLLER_NO_SLOT -1
+#define URING_FAILURE -1
+#define URING_SUBMISSION_QUEUE_DEPTH 256
+#define URING_COMPLETION_QUEUE_DEPTH 4096
+#define URING_RECV_BUFFER_COUNT 256  // power of two
+#define URING_RECV_BUFFER_GROUP 0
+#define URING_MIN_KERNEL_MAJOR 6  // multishot recv
+#define URING_MIN_KERNEL_MINOR 0
+#define EVENT_BACKEND_ENV "IRCSERV_EVENT_BACKEND"
+#define WORKERS_ENV "IRCSERV_WORKERS"
+#define SERVER_MAX_WORKERS 64
+#define PIPE_FAILURE -1
 #define MESSAGE_MAX_AMOUNT_PARAMETERS 15
 #define MAX_MSG_LENGTH 512
+#define COMMAND_HASH_SIZE 32  // power of two, see CommandId.h
 #define NICK_MAX_LENGTH_RFC2812 9
-#define SERVER_RECV_BUFFER_SIZE 1024
+#define SERVER_RECV_BUFFER_SIZE 4096
+#define URING_RECV_BUFFER_SIZE SERVER_RECV_BUFFER_SIZE
+#define SERVER_RECV_BUDGET_PER_EVENT 65536
+#define RECV_BUFFER_INITIAL_CAPACITY 4096
+#define SEND_QUEUE_CHUNK_SIZE 4096
+#define SEND_QUEUE_MAX_IOVECS 64
 #define RECV_ORDERLY_SHUTDOWN 0
 
 // Numeric reply names and numbers
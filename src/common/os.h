@@ -13,4 +13,33 @@
 #endif  // SO_NOSIGPIPE
 #endif  // __APPLE__
 
+#ifdef __linux__
+#define HAVE_EPOLL 1
+#define HAVE_ACCEPT4 1
+#else
+#define HAVE_EPOLL 0
+#define HAVE_ACCEPT4 0
+#endif  // __linux__
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING 1
+#endif
+#endif
+#ifndef HAVE_IO_URING
+#define HAVE_IO_URING 0
+#endif  // HAVE_IO_URING
+
+#if defined(__SSE2__)
+#define HAVE_SSE2 1
+#else
+#define HAVE_SSE2 0
+#endif  // __SSE2__
+
+#if HAVE_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_AVX2_TARGET 1  // AVX2 code can be compiled per function and picked at run time
+#else
+#define HAVE_AVX2_TARGET 0
+#endif
+
 #endif  // OS_H
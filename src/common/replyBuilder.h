@@ -0,0 +1,77 @@
+#ifndef REPLYBUILDER_H
+#define REPLYBUILDER_H
+
+#include <cstring>
+#include <initializer_list>
+#include <string>
+
+namespace irc {
+
+/**
+ * @brief One piece of an outgoing line, a view of a string that lives at least as long as the
+ * expression the line is built in.
+ */
+struct ReplyPart {
+    ReplyPart(const std::string& string) : data(string.data()), length(string.size()) {}
+    ReplyPart(const char* string) : data(string), length(std::strlen(string)) {}
+    ReplyPart(const char* bytes, unsigned long byteCount) : data(bytes), length(byteCount) {}
+
+    const char* data;
+    unsigned long length;
+};
+
+/**
+ * @class ReplyBuilder
+ * @brief The parts of one outgoing line, which the reply.h macros expand to.
+ *
+ * The size of the line is summed once while it is built, so it is written into its destination
+ * with at most one allocation: the tail of a client's SendQueue, a std::string that is reused or
+ * a std::string of exactly the right size, instead of a chain of operator+ temporaries.
+ *
+ * The parts are only views, so a ReplyBuilder has to be consumed within the full expression
+ * that built it. It cannot be copied, which keeps it from being returned or stored by mistake.
+ */
+class ReplyBuilder {
+   public:
+    ReplyBuilder(std::initializer_list<ReplyPart> parts) : parts_(parts), size_(0) {
+        for (const ReplyPart& part : parts_) {
+            size_ += part.length;
+        }
+    }
+
+    unsigned long size() const { return size_; }
+
+    /**
+     * @brief Appends the line to destination, growing it at most once.
+     */
+    void appendTo(std::string& destination) const {
+        unsigned long needed = destination.size() + size_;
+        if (needed > destination.capacity()) {
+            // Geometric growth, a send queue chunk is appended to many times
+            destination.reserve(needed > 2 * destination.capacity() ? needed : 2 * destination.capacity());
+        }
+        for (const ReplyPart& part : parts_) {
+            destination.append(part.data, part.length);
+        }
+    }
+
+    std::string toString() const {
+        std::string line;
+        line.reserve(size_);
+        appendTo(line);
+        return line;
+    }
+
+    operator std::string() const { return toString(); }
+
+   private:
+    ReplyBuilder(const ReplyBuilder&);
+    ReplyBuilder& operator=(const ReplyBuilder&);
+
+    std::initializer_list<ReplyPart> parts_;
+    unsigned long size_;
+};
+
+}  // namespace irc
+
+#endif
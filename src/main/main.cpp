@@ -6,6 +6,10 @@
  * It also performs argument validation and error handling.
  * 
  * The server can be started by providing two command-line arguments: the port number and the password.
+ * The event backend can be selected with the IRCSERV_EVENT_BACKEND environment variable ("poll", "epoll" or "io_uring").
+ * The amount of reactor threads can be set with the IRCSERV_WORKERS environment variable (default 1).
+ * Commands that reach other clients or channels still share one lock between the workers, so the
+ * default stays the recommended setting until more workers are measured on several cores.
  * 
  * Supported signals:
  * - SIGINT:   server received SIGINT (Ctrl+C)
@@ -25,7 +29,7 @@
 /**
  * @brief Indicates whether the server is currently running or not.
  */
-bool isServerRunning_g = false;
+std::atomic<bool> isServerRunning_g(false);
 
 /**
  * @brief The hostname of the server.
@@ -92,6 +96,28 @@ int main(int argc, char** argv) {
     signal(SIGHUP, signalHandler);   // parent dead
 
     irc::Server server(argv[1], argv[2]);
+    const char* eventBackendName = std::getenv(EVENT_BACKEND_ENV);
+    if (eventBackendName != NULL) {
+        irc::Poller::Backend eventBackend;
+        if (irc::Poller::parseBackend(eventBackendName, eventBackend) == FAILURE) {
+            LOG_ERROR("main: invalid " << EVENT_BACKEND_ENV << " \"" << eventBackendName << "\", expected \"poll\", \"epoll\" or \"io_uring\"");
+            return EXIT_FAILURE;
+        }
+        server.setEventBackend(eventBackend);
+    }
+    const char* workerCountString = std::getenv(WORKERS_ENV);
+    if (workerCountString != NULL) {
+        int workerCount = 0;
+        try {
+            workerCount = std::stoi(workerCountString);
+        } catch (std::exception& e) {
+            workerCount = 0;
+        }
+        if (server.setWorkerCount(workerCount) == FAILURE) {
+            LOG_ERROR("main: invalid " << WORKERS_ENV << " \"" << workerCountString << "\", expected 1 to " << SERVER_MAX_WORKERS);
+            return EXIT_FAILURE;
+        }
+    }
     if (server.start() != SUCCESS)
         return EXIT_FAILURE;
     try {
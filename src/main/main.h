@@ -8,6 +8,7 @@
 
 // system definitions
 #include <csignal>
+#include <cstdlib>
 #include <stdexcept>
 #include <string>
 
@@ -0,0 +1,101 @@
+#ifndef COMMANDID_H
+#define COMMANDID_H
+
+#include <cstring>
+
+#include "../common/magicNumber.h"
+
+namespace irc {
+
+/**
+ * @brief The commands the server knows, resolved once when a Message is parsed.
+ */
+enum CommandId {
+    COMMAND_UNKNOWN,
+    COMMAND_CAP,
+    COMMAND_CHANNEL,
+    COMMAND_INVITE,
+    COMMAND_JOIN,
+    COMMAND_KICK,
+    COMMAND_MODE,
+    COMMAND_NICK,
+    COMMAND_PART,
+    COMMAND_PASS,
+    COMMAND_PING,
+    COMMAND_PRIVMSG,
+    COMMAND_QUIT,
+    COMMAND_TOPIC,
+    COMMAND_USER,
+    COMMAND_COUNT
+};
+
+struct CommandName {
+    const char* name;
+    unsigned long length;
+    CommandId id;
+};
+
+/**
+ * @brief The name of every CommandId, indexed by it.
+ */
+constexpr CommandName commandNames[COMMAND_COUNT] = {
+    {"", 0, COMMAND_UNKNOWN},         {"CAP", 3, COMMAND_CAP},       {"CHANNEL", 7, COMMAND_CHANNEL}, {"INVITE", 6, COMMAND_INVITE},
+    {"JOIN", 4, COMMAND_JOIN},        {"KICK", 4, COMMAND_KICK},     {"MODE", 4, COMMAND_MODE},       {"NICK", 4, COMMAND_NICK},
+    {"PART", 4, COMMAND_PART},        {"PASS", 4, COMMAND_PASS},     {"PING", 4, COMMAND_PING},       {"PRIVMSG", 7, COMMAND_PRIVMSG},
+    {"QUIT", 4, COMMAND_QUIT},        {"TOPIC", 5, COMMAND_TOPIC},   {"USER", 4, COMMAND_USER},
+};
+
+/**
+ * @brief Hashes a command name by its first and last character and its length.
+ *
+ * The constants were searched for so that no two known names share a slot of the
+ * COMMAND_HASH_SIZE table, which the static_assert below checks at compile time.
+ */
+constexpr unsigned long hashCommandName(const char* name, unsigned long length) {
+    return (static_cast<unsigned char>(name[0]) + static_cast<unsigned char>(name[length - 1]) + 6 * length) & (COMMAND_HASH_SIZE - 1);
+}
+
+struct CommandHashTable {
+    CommandId slots[COMMAND_HASH_SIZE];
+};
+
+constexpr CommandHashTable makeCommandHashTable() {
+    CommandHashTable table = {};
+    for (int id = COMMAND_UNKNOWN + 1; id < COMMAND_COUNT; id++) {
+        table.slots[hashCommandName(commandNames[id].name, commandNames[id].length)] = commandNames[id].id;
+    }
+    return table;
+}
+
+constexpr CommandHashTable commandHashTable = makeCommandHashTable();
+
+constexpr bool isPerfectCommandHash() {
+    for (int id = COMMAND_UNKNOWN + 1; id < COMMAND_COUNT; id++) {
+        if (commandNames[id].id != id || commandHashTable.slots[hashCommandName(commandNames[id].name, commandNames[id].length)] != id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isPerfectCommandHash(), "two command names share a hash slot or commandNames is out of order");
+
+/**
+ * @brief Resolves an uppercase command name with one hash, one table load and one compare.
+ *
+ * @return CommandId The command, COMMAND_UNKNOWN for any name the server does not know.
+ */
+inline CommandId lookupCommandId(const char* name, unsigned long length) {
+    if (length == 0) {
+        return COMMAND_UNKNOWN;
+    }
+    const CommandName& candidate = commandNames[commandHashTable.slots[hashCommandName(name, length)]];
+    if (candidate.length != length || std::memcmp(candidate.name, name, length) != 0) {
+        return COMMAND_UNKNOWN;
+    }
+    return candidate.id;
+}
+
+}  // namespace irc
+
+#endif
@@ -1,42 +1,137 @@
 #include "Message.h"
 
 namespace irc {
+
+static bool isStreamSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+std::string Message::View::toString() const {
+    return std::string(data, length);
+}
+
+bool Message::View::equals(const char* string) const {
+    return std::strlen(string) == length && std::memcmp(data, string, length) == 0;
+}
+
 /****
     * The message object constructor is parsing the IRC received messages
     * and initializes its prefix (OPTIONAL), command and parameters.
     */
-Message::Message(const std::string serializedMessage) : numeric_(0) {
-    checkNulChar(serializedMessage);
-    checkMessageLength(serializedMessage);
-    deserialize_(serializedMessage);
+Message::Message(const std::string& serializedMessage) : Message(serializedMessage.data(), serializedMessage.length()) {}
+
+/****
+    * Same as above for a line that is not held in a std::string.
+    * The bytes are copied, the line may change afterwards.
+    */
+Message::Message(const char* serializedMessage, unsigned long length) {
+    checkNulChar(serializedMessage, length);
+    parse_(serializedMessage, length);
+}
+
+/****
+    * Same as above for a line framed by a RecvBuffer, which already knows
+    * whether the line contains a NUL character or was too long.
+    */
+Message::Message(const RecvBuffer::Line& line) {
+    if (line.containsNul) {
+        LOG_DEBUG("Message::Message: message contains illegal NUL Character");
+        numeric_ = ERR_CUSTOM_ILLEGALNUL;
+    }
+    if (line.isTooLong) {
+        LOG_DEBUG("Message::Message: message was longer than " << MAX_MSG_LENGTH << " characters");
+        numeric_ = ERR_INPUTTOOLONG;
+    }
+    parse_(line.data, line.length);
+}
+
+/**
+ * @brief Copies the line into the message and parses the copy.
+ */
+void Message::parse_(const char* serializedMessage, unsigned long length) {
+    length_ = length;
+    char* line = line_;
+    if (length > MAX_MSG_LENGTH) {
+        overlongLine_.assign(serializedMessage, length);
+        line = &overlongLine_[0];
+    } else if (length > 0) {
+        std::memcpy(line_, serializedMessage, length);
+    }
+    checkMessageLength(length);
+    deserialize_(line, length);
 }
 
 Message::~Message(){};
 
 std::string Message::getPrefix() const {
-    return prefix_;
+    return getPrefixView().toString();
 }
 
 std::string Message::getCommand() const {
-    return command_;
+    return getCommandView().toString();
+}
+
+CommandId Message::getCommandId() const {
+    return commandId_;
 }
 
 std::vector<std::string> Message::getParameters() const {
-    return parameters_;
+    std::vector<std::string> parameters;
+    parameters.reserve(parameterCount_);
+    for (unsigned long i = 0; i < parameterCount_; i++) {
+        parameters.emplace_back(base_() + parameters_[i].offset, parameters_[i].length);
+    }
+    return parameters;
 }
 
 int Message::getNumeric() const {
     return numeric_;
 }
 
+Message::View Message::getPrefixView() const {
+    return view_(prefix_);
+}
+
+Message::View Message::getCommandView() const {
+    return view_(command_);
+}
+
+unsigned long Message::getParameterCount() const {
+    return parameterCount_;
+}
+
+/**
+ * @brief Returns the parameter at index, an empty view if there is none.
+ */
+Message::View Message::getParameterView(unsigned long index) const {
+    if (index >= parameterCount_) {
+        return View{base_(), 0};
+    }
+    return view_(parameters_[index]);
+}
+
+/**
+ * @brief The parsed line, offsets stay valid when the Message is copied.
+ */
+const char* Message::base_() const {
+    if (length_ > MAX_MSG_LENGTH) {
+        return overlongLine_.data();
+    }
+    return line_;
+}
+
+Message::View Message::view_(const Token& token) const {
+    return View{base_() + token.offset, token.length};
+}
+
 /****
     * The NUL (%x00) character is not special in message framing, and
     * basically could end up inside a parameter, but it would cause
     * extra complexities in normal C string handling. Therefore, NUL
     * is not allowed within messages.
     */
-void Message::checkNulChar(const std::string& serializedMessage) {
-    if (serializedMessage.find('\0') != std::string::npos) {
+void Message::checkNulChar(const char* serializedMessage, unsigned long length) {
+    if (length > 0 && std::memchr(serializedMessage, '\0', length) != NULL) {
         LOG_DEBUG("Message::checkNulChar: message contains illegal NUL Character");
         numeric_ = ERR_CUSTOM_ILLEGALNUL;
     }
@@ -50,9 +145,9 @@ void Message::checkNulChar(const std::string& serializedMessage) {
     * for the command and its parameters.  There is no provision for
     * continuation of message lines. 
     */
-void Message::checkMessageLength(const std::string& serializedMessage) {
-    if (serializedMessage.length() > MAX_MSG_LENGTH) {
-        LOG_DEBUG("Message::checkMessageLength: message was too long, " << serializedMessage.length() << " instead of 512");
+void Message::checkMessageLength(unsigned long length) {
+    if (length > MAX_MSG_LENGTH) {
+        LOG_DEBUG("Message::checkMessageLength: message was too long, " << length << " instead of 512");
         numeric_ = ERR_INPUTTOOLONG;
     }
 }
@@ -70,12 +165,17 @@ void Message::checkMessageLength(const std::string& serializedMessage) {
     * 
     * prefix =  servername / ( nickname [ [ "!" user ] "@" host ] )
     */
-void Message::setPrefix_(std::istringstream& serializedStream) {
-    // Sneak peek into the first char of stream for a semicolon ":"
-    if (serializedStream.peek() == ':') {
-        serializedStream >> prefix_;
-        LOG_DEBUG("Message::setPrefix_: got prefix_: " + prefix_);
+unsigned long Message::setPrefix_(const char* line, unsigned long length) {
+    // Sneak peek into the first char of the line for a colon ":"
+    unsigned long position = 0;
+    if (length > 0 && line[0] == ':') {
+        while (position < length && !isStreamSpace(line[position])) {
+            position++;
+        }
+        prefix_ = Token{0, position};
+        LOG_DEBUG("Message::setPrefix_: got prefix_: " << getPrefix());
     }
+    return position;
 }
 
 /****
@@ -84,9 +184,18 @@ void Message::setPrefix_(std::istringstream& serializedStream) {
     * 
     * command =  1*letter / 3digit
     */
-void Message::setCommand_(std::istringstream& serializedMessage) {
-    serializedMessage >> command_;
-    std::transform(command_.begin(), command_.end(), command_.begin(), ::toupper);
+unsigned long Message::setCommand_(char* line, unsigned long length, unsigned long position) {
+    while (position < length && isStreamSpace(line[position])) {
+        position++;
+    }
+    unsigned long start = position;
+    while (position < length && !isStreamSpace(line[position])) {
+        line[position] = static_cast<char>(std::toupper(static_cast<unsigned char>(line[position])));
+        position++;
+    }
+    command_ = Token{start, position - start};
+    commandId_ = lookupCommandId(line + start, position - start);
+    return position;
 }
 
 /****
@@ -96,30 +205,35 @@ void Message::setCommand_(std::istringstream& serializedMessage) {
     * params =  *14( SPACE middle ) [ SPACE ":" trailing ]
     *        =/ 14( SPACE middle ) [ SPACE [ ":" ] trailing ]
     */
-void Message::setParameters_(std::istringstream& serializedMessage) {
-    std::string parameter;
-    serializedMessage >> std::ws;  // Discards leading whitespaces
-    while (std::getline(serializedMessage, parameter, ' ')) {
+void Message::setParameters_(const char* line, unsigned long length, unsigned long position) {
+    while (position < length && isStreamSpace(line[position])) {  // Discards leading whitespaces
+        position++;
+    }
+    while (position < length) {
+        const char* space = static_cast<const char*>(std::memchr(line + position, ' ', length - position));
+        unsigned long end = (space != NULL) ? static_cast<unsigned long>(space - line) : length;
+        unsigned long next = (space != NULL) ? end + 1 : length;
+        if (parameterCount_ == MESSAGE_MAX_AMOUNT_PARAMETERS) {
+            LOG_DEBUG("Message::setParameters_: too many parameters in message");
+            numeric_ = ERR_CUSTOM_TOOMANYPARAMS;
+            break;
+        }
         // If the parameter starts with a colon, it's a trailing parameter
-        if (parameter[0] == ':') {
-            // Add the rest of the line as a single trailing parameter
-            std::string trailingParameter;
-            std::getline(serializedMessage, trailingParameter);
-            if (!trailingParameter.empty()) {
-                parameters_.push_back(parameter + " " + trailingParameter);
-            } else {
-                parameters_.push_back(parameter);
+        if (end > position && line[position] == ':') {
+            // The rest of the line up to a newline joins it as a single trailing parameter
+            const char* newline = static_cast<const char*>(std::memchr(line + next, '\n', length - next));
+            unsigned long restEnd = (newline != NULL) ? static_cast<unsigned long>(newline - line) : length;
+            if (restEnd > next) {
+                end = restEnd;
             }
+            parameters_[parameterCount_++] = Token{position, end - position};
             break;  // No more parameters after a trailing parameter
         }
         // If the parameter does not start with a colon, it's a regular parameter
-        parameters_.push_back(parameter);
-    }
-    if (parameters_.size() > MESSAGE_MAX_AMOUNT_PARAMETERS) {
-        LOG_DEBUG("Message::setParameters_: too many parameters in message");
-        numeric_ = ERR_CUSTOM_TOOMANYPARAMS;
+        parameters_[parameterCount_++] = Token{position, end - position};
+        position = next;
     }
-    LOG_DEBUG("Message::setParameters_: got parameters_ (count): " + std::to_string(parameters_.size()));
+    LOG_DEBUG("Message::setParameters_: got parameters_ (count): " << parameterCount_);
 }
 
 /****
@@ -141,14 +255,12 @@ void Message::setParameters_(std::istringstream& serializedMessage) {
     * SPACE      =  %x20        ; space character
     * crlf       =  %x0D %x0A   ; "carriage return" "linefeed"
     */
-void Message::deserialize_(const std::string& serializedMessage) {
-    std::istringstream iss(serializedMessage);
-
-    setPrefix_(iss);
-    LOG_DEBUG("Message::deserialize_: got prefix_: " + prefix_);
-    setCommand_(iss);
-    LOG_DEBUG("Message::deserialize_: got command_: " + command_);
-    setParameters_(iss);
+void Message::deserialize_(char* line, unsigned long length) {
+    unsigned long position = setPrefix_(line, length);
+    LOG_DEBUG("Message::deserialize_: got prefix_: " << getPrefix());
+    position = setCommand_(line, length, position);
+    LOG_DEBUG("Message::deserialize_: got command_: " << getCommand());
+    setParameters_(line, length, position);
 }
 
 }  // namespace irc
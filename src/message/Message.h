@@ -1,40 +1,87 @@
 #ifndef MESSAGE_H
 #define MESSAGE_H
 
-#include <algorithm>
-#include <sstream>
+#include <cctype>
+#include <cstring>
 #include <string>
 #include <vector>
+#include "../buffer/RecvBuffer.h"
 #include "../common/log.h"
 #include "../common/magicNumber.h"
+#include "CommandId.h"
 
 namespace irc {
 
+/**
+ * @class Message
+ * @brief One IRC message parsed in a single pass.
+ *
+ * The line is copied into an inline buffer of MAX_MSG_LENGTH bytes (longer lines, which are
+ * rejected anyway, fall back to a heap copy) and prefix, command and parameters are kept as
+ * offsets into it, so parsing a message of legal length performs no heap allocation.
+ * The std::string getters build their result on demand, the view getters do not copy at all.
+ *
+ * The command name is resolved to a CommandId while parsing, so dispatching it needs no string
+ * compare. A message built from a RecvBuffer::Line reuses what the framing pass found out about NUL
+ * bytes instead of searching the line for them again.
+ */
 class Message {
-   private:
-    std::string prefix_;
-    std::string command_;
-    std::vector<std::string> parameters_;
-    int numeric_;
-    void deserialize_(const std::string& serializedMessage);
-    void setPrefix_(std::istringstream& serializedStream);
-    void setCommand_(std::istringstream& serializedMessage);
-    void setParameters_(std::istringstream& serializedStream);
-
-    void checkNulChar(const std::string& serializedMessage);
-    void checkMessageLength(const std::string& serializedMessage);
-
    public:
-    Message(std::string serializedMessage);
+    /**
+     * @brief A view of one part of the message, valid as long as the Message it came from.
+     */
+    struct View {
+        const char* data;
+        unsigned long length;
+        std::string toString() const;
+        bool equals(const char* string) const;
+    };
+
+    Message(const std::string& serializedMessage);
+    Message(const char* serializedMessage, unsigned long length);
+    Message(const RecvBuffer::Line& line);
 
     ~Message();
 
     std::string getPrefix() const;
     std::string getCommand() const;
+    CommandId getCommandId() const;
     int getNumeric() const;
     std::vector<std::string> getParameters() const;
 
+    View getPrefixView() const;
+    View getCommandView() const;
+    unsigned long getParameterCount() const;
+    View getParameterView(unsigned long index) const;
+
     // std::string serialize() const;
+
+   private:
+    struct Token {
+        unsigned long offset;
+        unsigned long length;
+    };
+
+    const char* base_() const;
+    View view_(const Token& token) const;
+    void parse_(const char* serializedMessage, unsigned long length);
+    void deserialize_(char* line, unsigned long length);
+    unsigned long setPrefix_(const char* line, unsigned long length);
+    unsigned long setCommand_(char* line, unsigned long length, unsigned long position);
+    void setParameters_(const char* line, unsigned long length, unsigned long position);
+
+    void checkNulChar(const char* serializedMessage, unsigned long length);
+    void checkMessageLength(unsigned long length);
+
+    char line_[MAX_MSG_LENGTH];
+    std::string overlongLine_;  // only used for lines longer than MAX_MSG_LENGTH
+    unsigned long length_ = 0;
+    Token prefix_ = {0, 0};
+    Token command_ = {0, 0};
+    CommandId commandId_ = COMMAND_UNKNOWN;
+    Token parameters_[MESSAGE_MAX_AMOUNT_PARAMETERS];
+    unsigned long parameterCount_ = 0;
+    int numeric_ = 0;
 };
 
 }  // namespace irc
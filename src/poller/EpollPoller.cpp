@@ -0,0 +1,87 @@
+#include "EpollPoller.h"
+
+#if HAVE_EPOLL
+
+namespace irc {
+
+EpollPoller::EpollPoller() : readyEvents_(EPOLL_MAX_EVENTS_PER_WAIT) {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ == EPOLL_FAILURE) {
+        LOG_ERROR("EpollPoller::EpollPoller: epoll_create1 failed: " << strerror(errno));
+    }
+}
+
+EpollPoller::~EpollPoller() {
+    if (epollFd_ != EPOLL_FAILURE) {
+        close(epollFd_);
+    }
+}
+
+bool EpollPoller::isValid() const {
+    return epollFd_ != EPOLL_FAILURE;
+}
+
+int EpollPoller::control_(int operation, int fd, bool wantWrite) {
+    epoll_event event;
+    memset(&event, 0, sizeof event);
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (wantWrite) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd_, operation, fd, &event) == EPOLL_FAILURE) {
+        LOG_ERROR("EpollPoller::control_: epoll_ctl failed for fd " << fd << ": " << strerror(errno));
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+int EpollPoller::add(int fd, bool wantWrite) {
+    return control_(EPOLL_CTL_ADD, fd, wantWrite);
+}
+
+int EpollPoller::modify(int fd, bool wantWrite) {
+    return control_(EPOLL_CTL_MOD, fd, wantWrite);
+}
+
+int EpollPoller::remove(int fd) {
+    if (epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, NULL) == EPOLL_FAILURE) {
+        LOG_WARNING("EpollPoller::remove: epoll_ctl failed for fd " << fd << ": " << strerror(errno));
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Waits for events and appends the ready descriptors to events.
+ *
+ * At most EPOLL_MAX_EVENTS_PER_WAIT descriptors are reported per call,
+ * the rest stay queued in the kernel for the next call.
+ *
+ * @return int The number of ready descriptors, or POLL_FAILURE with errno set.
+ */
+int EpollPoller::wait(std::vector<Event>& events, int timeoutMs) {
+    events.clear();
+    int ready = epoll_wait(epollFd_, readyEvents_.data(), static_cast<int>(readyEvents_.size()), timeoutMs);
+    if (ready == EPOLL_FAILURE) {
+        return POLL_FAILURE;
+    }
+    for (int i = 0; i < ready; i++) {
+        const epoll_event& readyEvent = readyEvents_[static_cast<unsigned long>(i)];
+        Event event;
+        event.fd = readyEvent.data.fd;
+        event.readable = (readyEvent.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0;
+        event.writable = (readyEvent.events & EPOLLOUT) != 0;
+        event.error = (readyEvent.events & EPOLLERR) != 0;
+        events.push_back(event);
+    }
+    return ready;
+}
+
+Poller::Backend EpollPoller::getBackend() const {
+    return BACKEND_EPOLL;
+}
+
+}  // namespace irc
+
+#endif  // HAVE_EPOLL
@@ -0,0 +1,46 @@
+#ifndef EPOLLPOLLER_H
+#define EPOLLPOLLER_H
+
+#include "Poller.h"
+
+#if HAVE_EPOLL
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace irc {
+
+/**
+ * @class EpollPoller
+ * @brief Linux epoll based Poller, the cost of wait() scales with the number of ready descriptors.
+ *
+ * Notifications are level-triggered: the server reads and accepts a bounded amount per event
+ * and relies on a descriptor with data left being reported again by the next wait().
+ */
+class EpollPoller : public Poller {
+   public:
+    EpollPoller();
+    ~EpollPoller();
+    bool isValid() const;
+    int add(int fd, bool wantWrite);
+    int modify(int fd, bool wantWrite);
+    int remove(int fd);
+    int wait(std::vector<Event>& events, int timeoutMs);
+    Backend getBackend() const;
+
+   private:
+    EpollPoller(const EpollPoller& other);
+    EpollPoller& operator=(const EpollPoller& other);
+    int control_(int operation, int fd, bool wantWrite);
+    int epollFd_;
+    std::vector<epoll_event> readyEvents_;
+};
+
+}  // namespace irc
+
+#endif  // HAVE_EPOLL
+
+#endif
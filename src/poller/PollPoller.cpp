@@ -0,0 +1,95 @@
+#include "PollPoller.h"
+
+namespace irc {
+
+PollPoller::PollPoller() {}
+
+PollPoller::~PollPoller() {}
+
+static short pollEventsFor(bool wantWrite) {
+    return static_cast<short>(wantWrite ? (POLLIN | POLLOUT | POLLERR) : (POLLIN | POLLERR));
+}
+
+int PollPoller::findSlot_(int fd) const {
+    if (fd < 0 || static_cast<unsigned long>(fd) >= slotByFd_.size()) {
+        return POLLER_NO_SLOT;
+    }
+    return slotByFd_[static_cast<unsigned long>(fd)];
+}
+
+int PollPoller::add(int fd, bool wantWrite) {
+    if (fd < 0 || findSlot_(fd) != POLLER_NO_SLOT) {
+        LOG_WARNING("PollPoller::add: fd " << fd << " is invalid or already registered");
+        return FAILURE;
+    }
+    if (static_cast<unsigned long>(fd) >= slotByFd_.size()) {
+        slotByFd_.resize(static_cast<unsigned long>(fd) + 1, POLLER_NO_SLOT);
+    }
+    pollfd newPollfd;
+    newPollfd.fd = fd;
+    newPollfd.events = pollEventsFor(wantWrite);
+    newPollfd.revents = 0;
+    slotByFd_[static_cast<unsigned long>(fd)] = static_cast<int>(pollfds_.size());
+    pollfds_.push_back(newPollfd);
+    return SUCCESS;
+}
+
+int PollPoller::modify(int fd, bool wantWrite) {
+    int slot = findSlot_(fd);
+    if (slot == POLLER_NO_SLOT) {
+        LOG_WARNING("PollPoller::modify: fd " << fd << " is not registered");
+        return FAILURE;
+    }
+    pollfds_[static_cast<unsigned long>(slot)].events = pollEventsFor(wantWrite);
+    return SUCCESS;
+}
+
+/**
+ * @brief Unregisters fd by moving the last entry into its slot.
+ */
+int PollPoller::remove(int fd) {
+    int slot = findSlot_(fd);
+    if (slot == POLLER_NO_SLOT) {
+        LOG_WARNING("PollPoller::remove: fd " << fd << " is not registered");
+        return FAILURE;
+    }
+    pollfd& last = pollfds_.back();
+    pollfds_[static_cast<unsigned long>(slot)] = last;
+    slotByFd_[static_cast<unsigned long>(last.fd)] = slot;
+    pollfds_.pop_back();
+    slotByFd_[static_cast<unsigned long>(fd)] = POLLER_NO_SLOT;
+    return SUCCESS;
+}
+
+/**
+ * @brief Waits for events and appends the ready descriptors to events.
+ *
+ * @return int The number of ready descriptors, or POLL_FAILURE with errno set.
+ */
+int PollPoller::wait(std::vector<Event>& events, int timeoutMs) {
+    events.clear();
+    int ready = poll(pollfds_.data(), static_cast<nfds_t>(pollfds_.size()), timeoutMs);
+    if (ready == POLL_FAILURE) {
+        return POLL_FAILURE;
+    }
+    int found = 0;
+    for (std::vector<pollfd>::iterator it = pollfds_.begin(); it != pollfds_.end() && found < ready; it++) {
+        if (it->revents == 0) {
+            continue;
+        }
+        Event event;
+        event.fd = it->fd;
+        event.readable = (it->revents & (POLLIN | POLLHUP)) != 0;
+        event.writable = (it->revents & POLLOUT) != 0;
+        event.error = (it->revents & (POLLERR | POLLNVAL)) != 0;
+        events.push_back(event);
+        found++;
+    }
+    return found;
+}
+
+Poller::Backend PollPoller::getBackend() const {
+    return BACKEND_POLL;
+}
+
+}  // namespace irc
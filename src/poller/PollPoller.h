@@ -0,0 +1,41 @@
+#ifndef POLLPOLLER_H
+#define POLLPOLLER_H
+
+#include <sys/poll.h>
+#include <cerrno>
+#include <vector>
+
+#include "Poller.h"
+
+namespace irc {
+
+/**
+ * @class PollPoller
+ * @brief Portable poll() based Poller, used as the fallback backend.
+ *
+ * poll() itself is O(watched descriptors) per call, this class only makes sure
+ * the caller receives the ready descriptors instead of the whole set.
+ *
+ * The pollfd array is kept dense with an fd-to-slot index: adding appends, removing
+ * moves the last entry into the freed slot, so registration changes are O(1)
+ * regardless of the amount of watched descriptors.
+ */
+class PollPoller : public Poller {
+   public:
+    PollPoller();
+    ~PollPoller();
+    int add(int fd, bool wantWrite);
+    int modify(int fd, bool wantWrite);
+    int remove(int fd);
+    int wait(std::vector<Event>& events, int timeoutMs);
+    Backend getBackend() const;
+
+   private:
+    int findSlot_(int fd) const;
+    std::vector<pollfd> pollfds_;
+    std::vector<int> slotByFd_;  // index into pollfds_ for every registered fd, POLLER_NO_SLOT otherwise
+};
+
+}  // namespace irc
+
+#endif
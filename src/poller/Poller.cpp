@@ -0,0 +1,116 @@
+#include "Poller.h"
+
+#include "EpollPoller.h"
+#include "PollPoller.h"
+#include "UringPoller.h"
+
+namespace irc {
+
+Poller::~Poller() {}
+
+/**
+ * @brief Registers an accepted connection, readiness backends watch it like any other descriptor.
+ */
+int Poller::addConnection(int fd) {
+    return add(fd, false);
+}
+
+/**
+ * @brief Registers a listening socket, readiness backends watch it like any other descriptor.
+ */
+int Poller::addListener(int fd) {
+    return add(fd, false);
+}
+
+/**
+ * @brief Sends the iovecs to fd, readiness backends send right away with a single sendmsg().
+ *
+ * @return long long The amount of bytes taken from the iovecs, or SEND_FAILURE with errno set.
+ */
+long long Poller::send(int fd, const struct iovec* iovecs, int iovecCount) {
+    struct msghdr header;
+    memset(&header, 0, sizeof header);
+    header.msg_iov = const_cast<struct iovec*>(iovecs);
+    header.msg_iovlen = static_cast<size_t>(iovecCount);
+    return sendmsg(fd, &header, MSG_NOSIGNAL);
+}
+
+/**
+ * @brief Creates the requested backend, falling back to poll() if it is not available.
+ *
+ * @param backend The preferred backend.
+ * @return std::unique_ptr<Poller> A ready to use poller.
+ */
+std::unique_ptr<Poller> Poller::create(Backend backend) {
+#if HAVE_IO_URING
+    if (backend == BACKEND_URING) {
+        std::unique_ptr<UringPoller> uringPoller(new UringPoller());
+        if (uringPoller->isValid()) {
+            LOG_DEBUG("Poller::create: using io_uring backend");
+            return std::unique_ptr<Poller>(uringPoller.release());
+        }
+        backend = getDefaultBackend();
+        LOG_WARNING("Poller::create: io_uring is not available, falling back to " << getBackendName(backend));
+    }
+#else
+    if (backend == BACKEND_URING) {
+        backend = getDefaultBackend();
+        LOG_WARNING("Poller::create: io_uring is not supported on this platform, falling back to " << getBackendName(backend));
+    }
+#endif
+#if HAVE_EPOLL
+    if (backend == BACKEND_EPOLL) {
+        std::unique_ptr<EpollPoller> epollPoller(new EpollPoller());
+        if (epollPoller->isValid()) {
+            LOG_DEBUG("Poller::create: using epoll backend");
+            return std::unique_ptr<Poller>(epollPoller.release());
+        }
+        LOG_WARNING("Poller::create: epoll is not available, falling back to poll");
+    }
+#else
+    if (backend == BACKEND_EPOLL) {
+        LOG_WARNING("Poller::create: epoll is not supported on this platform, falling back to poll");
+    }
+#endif
+    LOG_DEBUG("Poller::create: using poll backend");
+    return std::unique_ptr<Poller>(new PollPoller());
+}
+
+Poller::Backend Poller::getDefaultBackend() {
+    return HAVE_EPOLL ? BACKEND_EPOLL : BACKEND_POLL;
+}
+
+/**
+ * @brief Parses a backend name ("poll", "epoll" or "io_uring") as given on startup.
+ *
+ * @return int SUCCESS if the name was recognised, FAILURE otherwise.
+ */
+int Poller::parseBackend(const std::string& name, Backend& backend) {
+    if (name == "poll") {
+        backend = BACKEND_POLL;
+        return SUCCESS;
+    }
+    if (name == "epoll") {
+        backend = BACKEND_EPOLL;
+        return SUCCESS;
+    }
+    if (name == "io_uring") {
+        backend = BACKEND_URING;
+        return SUCCESS;
+    }
+    return FAILURE;
+}
+
+std::string Poller::getBackendName(Backend backend) {
+    switch (backend) {
+        case BACKEND_POLL:
+            return "poll";
+        case BACKEND_EPOLL:
+            return "epoll";
+        case BACKEND_URING:
+            return "io_uring";
+    }
+    return "unknown";
+}
+
+}  // namespace irc
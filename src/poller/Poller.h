@@ -0,0 +1,62 @@
+#ifndef POLLER_H
+#define POLLER_H
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../common/log.h"
+#include "../common/magicNumber.h"
+#include "../common/os.h"
+
+namespace irc {
+
+/**
+ * @class Poller
+ * @brief Readiness notification backend used by the Server event loop.
+ *
+ * A Poller keeps the set of watched file descriptors and reports back only the
+ * descriptors that are ready, so the caller never has to walk idle connections.
+ * The concrete backend (poll, epoll or io_uring) is chosen once at startup with create().
+ *
+ * Connections and listeners registered with addConnection() and addListener() may be
+ * served by a completion-based backend (io_uring), which does the recv() and accept()
+ * itself and reports the result with the event (see Event::completed). Data is always
+ * sent with send(), which a completion-based backend queues instead of sending right away.
+ */
+class Poller {
+   public:
+    enum Backend { BACKEND_POLL, BACKEND_EPOLL, BACKEND_URING };
+
+    struct Event {
+        int fd;
+        bool readable;
+        bool writable;
+        bool error;
+        bool completed = false;        // the backend already did the I/O, see data and result
+        const char* data = nullptr;    // received bytes, valid until the next wait()
+        long long result = 0;          // amount of bytes received (0 on orderly shutdown), or the accepted fd
+    };
+
+    virtual ~Poller();
+    virtual int add(int fd, bool wantWrite) = 0;
+    virtual int addConnection(int fd);
+    virtual int addListener(int fd);
+    virtual int modify(int fd, bool wantWrite) = 0;
+    virtual int remove(int fd) = 0;
+    virtual int wait(std::vector<Event>& events, int timeoutMs) = 0;
+    virtual Backend getBackend() const = 0;
+    virtual long long send(int fd, const struct iovec* iovecs, int iovecCount);
+
+    static std::unique_ptr<Poller> create(Backend backend);
+    static Backend getDefaultBackend();
+    static int parseBackend(const std::string& name, Backend& backend);
+    static std::string getBackendName(Backend backend);
+};
+
+}  // namespace irc
+
+#endif
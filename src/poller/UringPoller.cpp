@@ -0,0 +1,581 @@
+#include "UringPoller.h"
+
+#if HAVE_IO_URING
+
+namespace irc {
+
+UringPoller::UringPoller()
+    : isValid_(false),
+      ringFd_(URING_FAILURE),
+      rings_(MAP_FAILED),
+      ringsSize_(0),
+      sqes_(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+      sqesSize_(0),
+      sqHead_(NULL),
+      sqTail_(NULL),
+      sqFlags_(NULL),
+      sqMask_(0),
+      sqEntries_(0),
+      sqLocalTail_(0),
+      cqHead_(NULL),
+      cqTail_(NULL),
+      cqMask_(0),
+      cqes_(NULL),
+      bufferRing_(static_cast<struct io_uring_buf_ring*>(MAP_FAILED)),
+      bufferRingSize_(0),
+      bufferRingTail_(0) {
+    if (isKernelSupported_() == false) {
+        LOG_WARNING("UringPoller::UringPoller: kernel older than " << URING_MIN_KERNEL_MAJOR << "." << URING_MIN_KERNEL_MINOR);
+        return;
+    }
+    if (setupRings_() == FAILURE || setupBufferRing_() == FAILURE) {
+        return;
+    }
+    isValid_ = true;
+}
+
+UringPoller::~UringPoller() {
+    if (ringFd_ != URING_FAILURE) {
+        // Closing the ring alone cancels the pending requests in the background,
+        // they must be gone before the buffers they point to are freed
+        struct io_uring_sync_cancel_reg cancel;
+        memset(&cancel, 0, sizeof cancel);
+        cancel.flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+        cancel.timeout.tv_sec = -1;
+        cancel.timeout.tv_nsec = -1;
+        int errno_before = errno;
+        syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_SYNC_CANCEL, &cancel, 1);
+        errno = errno_before;
+        close(ringFd_);
+    }
+    if (bufferRing_ != MAP_FAILED) {
+        munmap(bufferRing_, bufferRingSize_);
+    }
+    if (sqes_ != MAP_FAILED) {
+        munmap(sqes_, sqesSize_);
+    }
+    if (rings_ != MAP_FAILED) {
+        munmap(rings_, ringsSize_);
+    }
+}
+
+bool UringPoller::isValid() const {
+    return isValid_;
+}
+
+/**
+ * @brief Multishot recv, the oldest feature used here, needs a 6.0 kernel.
+ */
+bool UringPoller::isKernelSupported_() {
+    struct utsname name;
+    int major = 0;
+    int minor = 0;
+    if (uname(&name) != 0 || sscanf(name.release, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+    return major > URING_MIN_KERNEL_MAJOR || (major == URING_MIN_KERNEL_MAJOR && minor >= URING_MIN_KERNEL_MINOR);
+}
+
+/**
+ * @brief Packs the operation, the registration generation and the fd into the user_data of a request.
+ */
+uint64_t UringPoller::encode_(Operation operation, uint32_t generation, int fd) {
+    return (static_cast<uint64_t>(operation) << 56) | (static_cast<uint64_t>(generation & 0xffffff) << 32) |
+           static_cast<uint64_t>(static_cast<uint32_t>(fd));
+}
+
+int UringPoller::setupRings_() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof params);
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = URING_COMPLETION_QUEUE_DEPTH;
+    ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, URING_SUBMISSION_QUEUE_DEPTH, &params));
+    if (ringFd_ == URING_FAILURE) {
+        LOG_WARNING("UringPoller::setupRings_: io_uring_setup failed: " << strerror(errno));
+        return FAILURE;
+    }
+    unsigned int required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL | IORING_FEAT_POLL_32BITS | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        LOG_WARNING("UringPoller::setupRings_: missing io_uring features");
+        return FAILURE;
+    }
+    ringsSize_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+                          params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+    rings_ = mmap(NULL, ringsSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = static_cast<struct io_uring_sqe*>(mmap(NULL, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+    if (rings_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+        LOG_ERROR("UringPoller::setupRings_: mmap failed: " << strerror(errno));
+        return FAILURE;
+    }
+    char* rings = static_cast<char*>(rings_);
+    sqHead_ = reinterpret_cast<unsigned int*>(rings + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned int*>(rings + params.sq_off.tail);
+    sqFlags_ = reinterpret_cast<unsigned int*>(rings + params.sq_off.flags);
+    sqMask_ = *reinterpret_cast<unsigned int*>(rings + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    sqLocalTail_ = *sqTail_;
+    // Entry i of the submission array always points to sqe i, so it is written only once
+    unsigned int* sqArray = reinterpret_cast<unsigned int*>(rings + params.sq_off.array);
+    for (unsigned int i = 0; i < sqEntries_; i++) {
+        sqArray[i] = i;
+    }
+    cqHead_ = reinterpret_cast<unsigned int*>(rings + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned int*>(rings + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned int*>(rings + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(rings + params.cq_off.cqes);
+    return SUCCESS;
+}
+
+/**
+ * @brief Registers the ring of provided buffers the multishot recvs pick their buffer from.
+ */
+int UringPoller::setupBufferRing_() {
+    bufferRingSize_ = URING_RECV_BUFFER_COUNT * sizeof(struct io_uring_buf);
+    bufferRing_ = static_cast<struct io_uring_buf_ring*>(mmap(NULL, bufferRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (bufferRing_ == MAP_FAILED) {
+        LOG_ERROR("UringPoller::setupBufferRing_: mmap failed: " << strerror(errno));
+        return FAILURE;
+    }
+    struct io_uring_buf_reg registration;
+    memset(&registration, 0, sizeof registration);
+    registration.ring_addr = reinterpret_cast<uint64_t>(bufferRing_);
+    registration.ring_entries = URING_RECV_BUFFER_COUNT;
+    registration.bgid = URING_RECV_BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_PBUF_RING, &registration, 1) == URING_FAILURE) {
+        LOG_WARNING("UringPoller::setupBufferRing_: registering the buffer ring failed: " << strerror(errno));
+        return FAILURE;
+    }
+    buffers_.resize(URING_RECV_BUFFER_COUNT * URING_RECV_BUFFER_SIZE);
+    for (unsigned short id = 0; id < URING_RECV_BUFFER_COUNT; id++) {
+        handedOutBuffers_.push_back(id);
+    }
+    recycleBuffers_();
+    return SUCCESS;
+}
+
+UringPoller::Registration* UringPoller::findRegistration_(int fd) {
+    if (fd < 0 || static_cast<unsigned long>(fd) >= registrations_.size() ||
+        registrations_[static_cast<unsigned long>(fd)].kind == KIND_NONE) {
+        return NULL;
+    }
+    return &registrations_[static_cast<unsigned long>(fd)];
+}
+
+int UringPoller::register_(int fd, Kind kind, bool wantWrite) {
+    if (fd < 0) {
+        errno = EBADF;
+        return FAILURE;
+    }
+    if (static_cast<unsigned long>(fd) >= registrations_.size()) {
+        registrations_.resize(static_cast<unsigned long>(fd) + 1);
+    }
+    Registration& registration = registrations_[static_cast<unsigned long>(fd)];
+    if (registration.kind != KIND_NONE) {
+        LOG_ERROR("UringPoller::register_: fd " << fd << " is already registered");
+        errno = EEXIST;
+        return FAILURE;
+    }
+    registration.kind = kind;
+    registration.wantWrite = wantWrite;
+    if (arm_(fd, registration) == FAILURE) {
+        registration.kind = KIND_NONE;
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+int UringPoller::add(int fd, bool wantWrite) {
+    return register_(fd, KIND_POLL, wantWrite);
+}
+
+int UringPoller::addConnection(int fd) {
+    return register_(fd, KIND_CONNECTION, false);
+}
+
+int UringPoller::addListener(int fd) {
+    return register_(fd, KIND_LISTENER, false);
+}
+
+/**
+ * @brief Changes the write interest of a descriptor registered with add().
+ *
+ * Connections report writability through their send completions, the call only succeeds for them.
+ */
+int UringPoller::modify(int fd, bool wantWrite) {
+    Registration* registration = findRegistration_(fd);
+    if (registration == NULL) {
+        LOG_ERROR("UringPoller::modify: fd " << fd << " is not registered");
+        errno = ENOENT;
+        return FAILURE;
+    }
+    if (registration->kind != KIND_POLL || registration->wantWrite == wantWrite) {
+        registration->wantWrite = wantWrite;
+        return SUCCESS;
+    }
+    if (registration->armed) {
+        queueCancel_(encode_(OP_POLL, registration->generation, fd));
+    }
+    registration->generation++;
+    registration->wantWrite = wantWrite;
+    return arm_(fd, *registration);
+}
+
+/**
+ * @brief Cancels the pending requests of fd, completions still on their way are ignored.
+ *
+ * The cancellation is submitted right away: the kernel holds a reference to the socket while
+ * a request is pending, so the caller's close() would otherwise not close the connection.
+ * A send in flight is left to complete, its buffer is kept until then.
+ */
+int UringPoller::remove(int fd) {
+    Registration* registration = findRegistration_(fd);
+    if (registration == NULL) {
+        LOG_WARNING("UringPoller::remove: fd " << fd << " is not registered");
+        errno = ENOENT;
+        return FAILURE;
+    }
+    Operation operations[] = {OP_POLL, OP_POLL, OP_RECV, OP_ACCEPT};  // indexed by Kind
+    if (registration->armed) {
+        queueCancel_(encode_(operations[registration->kind], registration->generation, fd));
+    }
+    if (registration->sendInFlight) {
+        orphanedSends_[encode_(OP_SEND, registration->generation, fd)] = std::move(registration->sendBuffer);
+    }
+    bool submitNow = registration->kind != KIND_POLL;
+    uint32_t generation = registration->generation;
+    *registration = Registration();
+    registration->generation = generation + 1;
+    if (submitNow) {
+        submit_(0, 0);
+    }
+    return SUCCESS;
+}
+
+struct io_uring_sqe* UringPoller::getSqe_() {
+    if (sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+        submit_(0, 0);
+        if (sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+            LOG_ERROR("UringPoller::getSqe_: submission queue is full");
+            return NULL;
+        }
+    }
+    struct io_uring_sqe* sqe = &sqes_[sqLocalTail_ & sqMask_];
+    sqLocalTail_++;
+    memset(sqe, 0, sizeof *sqe);
+    return sqe;
+}
+
+/**
+ * @brief Submits the queued requests and, if minComplete is not 0, waits for completions.
+ *
+ * @return int SUCCESS, also when the wait timed out, or FAILURE with errno set.
+ */
+int UringPoller::submit_(unsigned int minComplete, int timeoutMs) {
+    __atomic_store_n(sqTail_, sqLocalTail_, __ATOMIC_RELEASE);
+    unsigned int toSubmit = sqLocalTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    unsigned int flags = 0;
+    struct io_uring_getevents_arg argument;
+    struct __kernel_timespec timeout;
+    memset(&argument, 0, sizeof argument);
+    if (minComplete > 0) {
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        if (timeoutMs != POLLER_WAIT_INFINITE) {
+            timeout.tv_sec = timeoutMs / 1000;
+            timeout.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+            argument.ts = reinterpret_cast<uint64_t>(&timeout);
+        }
+    }
+    if (toSubmit == 0 && flags == 0) {
+        return SUCCESS;
+    }
+    int errno_before = errno;
+    if (syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags, flags ? &argument : NULL, flags ? sizeof argument : 0) ==
+        URING_FAILURE) {
+        if (errno == ETIME || errno == EBUSY || errno == EAGAIN) {
+            errno = errno_before;  // timed out, or completions are waiting to be reaped
+            return SUCCESS;
+        }
+        if (errno != EINTR) {
+            LOG_ERROR("UringPoller::submit_: io_uring_enter failed: " << strerror(errno));
+        }
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+int UringPoller::arm_(int fd, Registration& registration) {
+    struct io_uring_sqe* sqe = getSqe_();
+    if (sqe == NULL) {
+        return FAILURE;
+    }
+    sqe->fd = fd;
+    switch (registration.kind) {
+        case KIND_POLL:
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->poll32_events = POLLIN | POLLRDHUP | (registration.wantWrite ? POLLOUT : 0);
+            sqe->user_data = encode_(OP_POLL, registration.generation, fd);
+            break;
+        case KIND_CONNECTION:
+            sqe->opcode = IORING_OP_RECV;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = URING_RECV_BUFFER_GROUP;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->user_data = encode_(OP_RECV, registration.generation, fd);
+            break;
+        case KIND_LISTENER:
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+            sqe->user_data = encode_(OP_ACCEPT, registration.generation, fd);
+            break;
+        case KIND_NONE:
+            break;
+    }
+    registration.armed = true;
+    return SUCCESS;
+}
+
+int UringPoller::queueSend_(int fd, Registration& registration) {
+    struct io_uring_sqe* sqe = getSqe_();
+    if (sqe == NULL) {
+        return FAILURE;
+    }
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(registration.sendBuffer.data() + registration.sendOffset);
+    sqe->len = static_cast<unsigned int>(registration.sendBuffer.size() - registration.sendOffset);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = encode_(OP_SEND, registration.generation, fd);
+    registration.sendInFlight = true;
+    return SUCCESS;
+}
+
+int UringPoller::queueCancel_(uint64_t userData) {
+    struct io_uring_sqe* sqe = getSqe_();
+    if (sqe == NULL) {
+        return FAILURE;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = userData;
+    sqe->user_data = encode_(OP_CANCEL, 0, 0);
+    return SUCCESS;
+}
+
+/**
+ * @brief Copies the data into the send buffer of the connection and queues one send for it.
+ *
+ * The copy lets the caller release its queue right away, the kernel reads the
+ * buffer whenever the socket becomes writable. Shared payloads are copied as
+ * well, so every recipient of a broadcast costs one copy of the message here.
+ *
+ * @return long long The amount of bytes taken, or SEND_FAILURE with errno EAGAIN while the
+ * previous send of the connection is still in flight.
+ */
+long long UringPoller::send(int fd, const struct iovec* iovecs, int iovecCount) {
+    Registration* registration = findRegistration_(fd);
+    if (registration == NULL || registration->kind != KIND_CONNECTION) {
+        return Poller::send(fd, iovecs, iovecCount);
+    }
+    if (registration->sendInFlight) {
+        registration->sendHeldBack = true;
+        errno = EAGAIN;
+        return SEND_FAILURE;
+    }
+    registration->sendBuffer.clear();
+    for (int i = 0; i < iovecCount; i++) {
+        const char* base = static_cast<const char*>(iovecs[i].iov_base);
+        registration->sendBuffer.insert(registration->sendBuffer.end(), base, base + iovecs[i].iov_len);
+    }
+    registration->sendOffset = 0;
+    if (registration->sendBuffer.empty()) {
+        return 0;
+    }
+    if (queueSend_(fd, *registration) == FAILURE) {
+        errno = EAGAIN;
+        return SEND_FAILURE;
+    }
+    return static_cast<long long>(registration->sendBuffer.size());
+}
+
+void UringPoller::provideBuffer_(unsigned short bufferId) {
+    // Only the fields of the entry are written, the tail of the ring shares the memory of resv.
+    // The entries are not reached through bufs: C++ gives the empty struct in front of the flexible array one byte.
+    struct io_uring_buf* entries = reinterpret_cast<struct io_uring_buf*>(bufferRing_);
+    struct io_uring_buf& buffer = entries[bufferRingTail_ & (URING_RECV_BUFFER_COUNT - 1)];
+    buffer.addr = reinterpret_cast<uint64_t>(&buffers_[static_cast<unsigned long>(bufferId) * URING_RECV_BUFFER_SIZE]);
+    buffer.len = URING_RECV_BUFFER_SIZE;
+    buffer.bid = bufferId;
+    bufferRingTail_++;
+}
+
+/**
+ * @brief Hands the buffers reported by the previous wait() back to the kernel.
+ */
+void UringPoller::recycleBuffers_() {
+    if (handedOutBuffers_.empty()) {
+        return;
+    }
+    for (unsigned short bufferId : handedOutBuffers_) {
+        provideBuffer_(bufferId);
+    }
+    handedOutBuffers_.clear();
+    __atomic_store_n(&bufferRing_->tail, bufferRingTail_, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Queues a new one-shot poll for the descriptors reported by the previous wait().
+ */
+void UringPoller::rearmPolls_() {
+    for (int fd : pollsToRearm_) {
+        Registration* registration = findRegistration_(fd);
+        if (registration != NULL && registration->kind == KIND_POLL && registration->armed == false) {
+            arm_(fd, *registration);
+        }
+    }
+    pollsToRearm_.clear();
+}
+
+/**
+ * @brief Waits for completions and appends them to events.
+ *
+ * Submits everything queued since the last call with the same system call. Received data
+ * stays valid until the next call, which returns its buffers to the kernel.
+ *
+ * @return int The number of events, or POLL_FAILURE with errno set.
+ */
+int UringPoller::wait(std::vector<Event>& events, int timeoutMs) {
+    events.clear();
+    recycleBuffers_();
+    rearmPolls_();
+    reapCompletions_(events);
+    unsigned int minComplete = (events.empty() && timeoutMs != 0) ? 1 : 0;
+    if (submit_(minComplete, timeoutMs) == FAILURE) {
+        return POLL_FAILURE;
+    }
+    reapCompletions_(events);
+    return static_cast<int>(events.size());
+}
+
+void UringPoller::reapCompletions_(std::vector<Event>& events) {
+    while (true) {
+        unsigned int head = *cqHead_;
+        unsigned int tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            handleCompletion_(cqes_[head & cqMask_], events);
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        if ((__atomic_load_n(sqFlags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) == 0) {
+            break;
+        }
+        // The kernel kept completions back while the ring was full, let it move them in
+        syscall(__NR_io_uring_enter, ringFd_, 0, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+}
+
+void UringPoller::handleCompletion_(const struct io_uring_cqe& cqe, std::vector<Event>& events) {
+    Operation operation = static_cast<Operation>(cqe.user_data >> 56);
+    uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32) & 0xffffff;
+    int fd = static_cast<int>(static_cast<uint32_t>(cqe.user_data));
+    bool hasMore = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        handedOutBuffers_.push_back(static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+    if (operation == OP_CANCEL) {
+        return;
+    }
+    Registration* registration = findRegistration_(fd);
+    bool isCurrent = registration != NULL && (registration->generation & 0xffffff) == generation;
+    if (isCurrent == false) {
+        if (operation == OP_SEND) {
+            orphanedSends_.erase(cqe.user_data);
+        } else if (operation == OP_ACCEPT && cqe.res >= 0) {
+            close(cqe.res);
+        }
+        return;
+    }
+
+    Event event;
+    event.fd = fd;
+    event.readable = false;
+    event.writable = false;
+    event.error = false;
+    switch (operation) {
+        case OP_POLL:
+            registration->armed = false;
+            pollsToRearm_.push_back(fd);
+            event.readable = (cqe.res & (POLLIN | POLLRDHUP | POLLHUP)) != 0;
+            event.writable = (cqe.res & POLLOUT) != 0;
+            event.error = cqe.res < 0 || (cqe.res & (POLLERR | POLLNVAL)) != 0;
+            break;
+        case OP_RECV:
+            if (hasMore == false) {
+                registration->armed = false;
+            }
+            if (cqe.res == -ENOBUFS) {
+                arm_(fd, *registration);  // every buffer is in use, they are back with the next wait()
+                return;
+            }
+            event.completed = true;
+            if (cqe.res < 0) {
+                event.error = true;
+                event.result = RECV_FAILURE;
+                break;
+            }
+            event.readable = true;
+            event.result = cqe.res;
+            if (cqe.res > 0) {
+                event.data = &buffers_[(cqe.flags >> IORING_CQE_BUFFER_SHIFT) * URING_RECV_BUFFER_SIZE];
+                if (hasMore == false) {
+                    arm_(fd, *registration);
+                }
+            }
+            break;
+        case OP_ACCEPT:
+            if (hasMore == false) {
+                registration->armed = false;
+                arm_(fd, *registration);
+            }
+            if (cqe.res < 0) {
+                if (cqe.res != -EAGAIN && cqe.res != -ECONNABORTED && cqe.res != -EINTR) {
+                    LOG_ERROR("UringPoller::handleCompletion_: accept failed on fd " << fd << ": " << strerror(-cqe.res));
+                }
+                return;
+            }
+            event.readable = true;
+            event.completed = true;
+            event.result = cqe.res;
+            break;
+        case OP_SEND:
+            if (cqe.res >= 0 && registration->sendOffset + static_cast<unsigned long>(cqe.res) < registration->sendBuffer.size()) {
+                registration->sendOffset += static_cast<unsigned long>(cqe.res);
+                queueSend_(fd, *registration);  // short send, the rest goes first
+                return;
+            }
+            registration->sendInFlight = false;
+            registration->sendBuffer.clear();
+            registration->sendOffset = 0;
+            if (cqe.res < 0) {
+                event.error = true;
+                break;
+            }
+            if (registration->sendHeldBack == false) {
+                return;
+            }
+            registration->sendHeldBack = false;
+            event.writable = true;
+            break;
+        case OP_CANCEL:
+            return;
+    }
+    events.push_back(event);
+}
+
+Poller::Backend UringPoller::getBackend() const {
+    return BACKEND_URING;
+}
+
+}  // namespace irc
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,125 @@
+#ifndef URINGPOLLER_H
+#define URINGPOLLER_H
+
+#include "Poller.h"
+
+#if HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace irc {
+
+/**
+ * @class UringPoller
+ * @brief Linux io_uring based Poller, does the socket I/O itself and reports completions.
+ *
+ * - Listeners (addListener()) get one multishot accept, every accepted connection is
+ *   reported as a completed event carrying the new fd.
+ * - Connections (addConnection()) get one multishot recv into a ring of provided buffers,
+ *   every received chunk is reported as a completed event pointing into that buffer.
+ * - send() copies the data into a per-connection buffer and queues a send. At most one send
+ *   per connection is in flight to keep the byte order, a writable event is reported when it
+ *   completes if the caller had to hold back data in the meantime. The copy includes shared
+ *   payloads, so on this backend a broadcast is copied once per recipient, while poll and
+ *   epoll hand the same payload to every sendmsg() without copying it.
+ * - Other descriptors (add()) are watched with one-shot poll requests that are re-armed on
+ *   every wait(), which gives the same level-triggered readiness events as the other backends.
+ *
+ * Every request queued since the last wait() is submitted by the io_uring_enter() that waits
+ * for the next completions, so a whole loop iteration costs a single system call.
+ *
+ * The rings are set up with raw system calls, no liburing needed. isValid() is false when the
+ * kernel is older than URING_MIN_KERNEL_MAJOR.URING_MIN_KERNEL_MINOR or io_uring is disabled,
+ * Poller::create() then falls back to the default backend.
+ */
+class UringPoller : public Poller {
+   public:
+    UringPoller();
+    ~UringPoller();
+    bool isValid() const;
+    int add(int fd, bool wantWrite);
+    int addConnection(int fd);
+    int addListener(int fd);
+    int modify(int fd, bool wantWrite);
+    int remove(int fd);
+    int wait(std::vector<Event>& events, int timeoutMs);
+    long long send(int fd, const struct iovec* iovecs, int iovecCount);
+    Backend getBackend() const;
+
+   private:
+    enum Kind { KIND_NONE, KIND_POLL, KIND_CONNECTION, KIND_LISTENER };
+    enum Operation { OP_POLL, OP_RECV, OP_ACCEPT, OP_SEND, OP_CANCEL };
+
+    struct Registration {
+        Kind kind = KIND_NONE;
+        uint32_t generation = 0;  // tells completions of a previous registration of the same fd apart
+        bool wantWrite = false;
+        bool armed = false;         // the poll, recv or accept request is pending in the kernel
+        bool sendInFlight = false;  // sendBuffer is owned by the kernel until the send completes
+        bool sendHeldBack = false;  // send() was refused while a send was in flight
+        std::vector<char> sendBuffer;  // a moved vector keeps its storage, the kernel may still read it
+        unsigned long sendOffset = 0;
+    };
+
+    UringPoller(const UringPoller& other);
+    UringPoller& operator=(const UringPoller& other);
+    static bool isKernelSupported_();
+    static uint64_t encode_(Operation operation, uint32_t generation, int fd);
+    int setupRings_();
+    int setupBufferRing_();
+    Registration* findRegistration_(int fd);
+    int register_(int fd, Kind kind, bool wantWrite);
+    struct io_uring_sqe* getSqe_();
+    int submit_(unsigned int minComplete, int timeoutMs);
+    int arm_(int fd, Registration& registration);
+    int queueSend_(int fd, Registration& registration);
+    int queueCancel_(uint64_t userData);
+    void provideBuffer_(unsigned short bufferId);
+    void recycleBuffers_();
+    void rearmPolls_();
+    void reapCompletions_(std::vector<Event>& events);
+    void handleCompletion_(const struct io_uring_cqe& cqe, std::vector<Event>& events);
+
+    bool isValid_;
+    int ringFd_;
+    void* rings_;  // submission and completion queue ring, mapped at once (IORING_FEAT_SINGLE_MMAP)
+    size_t ringsSize_;
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+    unsigned int* sqHead_;
+    unsigned int* sqTail_;
+    unsigned int* sqFlags_;
+    unsigned int sqMask_;
+    unsigned int sqEntries_;
+    unsigned int sqLocalTail_;
+    unsigned int* cqHead_;
+    unsigned int* cqTail_;
+    unsigned int cqMask_;
+    struct io_uring_cqe* cqes_;
+    struct io_uring_buf_ring* bufferRing_;
+    size_t bufferRingSize_;
+    unsigned short bufferRingTail_;
+    std::vector<char> buffers_;
+    std::vector<unsigned short> handedOutBuffers_;  // returned to the kernel by the next wait()
+    std::vector<Registration> registrations_;       // indexed by fd
+    std::vector<int> pollsToRearm_;
+    std::map<uint64_t, std::vector<char>> orphanedSends_;  // in flight when their connection was removed
+};
+
+}  // namespace irc
+
+#endif  // HAVE_IO_URING
+
+#endif
@@ -0,0 +1,107 @@
+#include "Reactor.h"
+
+namespace irc {
+
+/**
+ * @brief Creates the poller and the wake pipe, and registers the listener and the pipe.
+ * Check isValid() before using the reactor.
+ *
+ * @param listenFd The non-blocking listening socket of this reactor, not owned.
+ * @param backend The preferred event backend.
+ */
+Reactor::Reactor(int listenFd, Poller::Backend backend) : listenFd_(listenFd), isWakePending_(false), isValid_(false) {
+    wakePipe_[0] = PIPE_FAILURE;
+    wakePipe_[1] = PIPE_FAILURE;
+    if (pipe(wakePipe_) == PIPE_FAILURE) {
+        LOG_ERROR("Reactor::Reactor: pipe failed: " << strerror(errno));
+        return;
+    }
+    for (int fd : wakePipe_) {
+        if (fcntl(fd, F_SETFL, O_NONBLOCK) == FCNTL_FAILURE || fcntl(fd, F_SETFD, FD_CLOEXEC) == FCNTL_FAILURE) {
+            LOG_ERROR("Reactor::Reactor: fcntl failed on wake pipe: " << strerror(errno));
+            return;
+        }
+    }
+    poller_ = Poller::create(backend);
+    if (poller_->addListener(listenFd_) == FAILURE || poller_->add(wakePipe_[0], false) == FAILURE) {
+        LOG_ERROR("Reactor::Reactor: registering the listener and the wake pipe to the poller failed");
+        return;
+    }
+    isValid_ = true;
+}
+
+Reactor::~Reactor() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (int fd : wakePipe_) {
+        if (fd != PIPE_FAILURE) {
+            close(fd);
+        }
+    }
+}
+
+bool Reactor::isValid() const {
+    return isValid_;
+}
+
+int Reactor::getListenFd() const {
+    return listenFd_;
+}
+
+int Reactor::getWakeFd() const {
+    return wakePipe_[0];
+}
+
+Poller& Reactor::getPoller() {
+    return *poller_;
+}
+
+std::vector<Poller::Event>& Reactor::getEvents() {
+    return events_;
+}
+
+std::vector<int>& Reactor::getPendingWrites() {
+    return pendingWrites_;
+}
+
+std::vector<int>& Reactor::getFlushingWrites() {
+    return flushingWrites_;
+}
+
+std::vector<SendQueue>& Reactor::getFlushingQueues() {
+    return flushingQueues_;
+}
+
+std::thread& Reactor::getThread() {
+    return thread_;
+}
+
+/**
+ * @brief Interrupts the poller wait of this reactor, callable from any thread.
+ * A full pipe already guarantees a wakeup, so a failing write is not an error.
+ */
+void Reactor::wake() {
+    char byte = 0;
+    ssize_t ret = write(wakePipe_[1], &byte, 1);
+    (void)ret;
+}
+
+/**
+ * @brief Empties the wake pipe, called by the reactor thread when it is readable.
+ */
+void Reactor::drainWakeups() {
+    char buffer[64];
+    while (read(wakePipe_[0], buffer, sizeof buffer) > 0) {
+    }
+}
+
+bool Reactor::isWakePending() const {
+    return isWakePending_;
+}
+
+void Reactor::setWakePending(bool isWakePending) {
+    isWakePending_ = isWakePending;
+}
+
+}  // namespace irc
@@ -0,0 +1,68 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../buffer/SendQueue.h"
+#include "../common/log.h"
+#include "../common/magicNumber.h"
+#include "../poller/Poller.h"
+
+namespace irc {
+
+/**
+ * @class Reactor
+ * @brief One event loop of the server: a listening socket, a poller and the clients accepted on it.
+ *
+ * In multi-reactor mode every worker thread runs its own Reactor with its own SO_REUSEPORT
+ * listener, so the kernel spreads new connections over the workers. A client is only ever read,
+ * flushed and disconnected by the reactor that accepted it.
+ *
+ * Other reactors may queue data for its clients (e.g. a channel message), they then call wake(),
+ * which writes to a self-pipe watched by the poller, so the owner flushes without waiting for
+ * its next socket event.
+ */
+class Reactor {
+   public:
+    Reactor(int listenFd, Poller::Backend backend);
+    ~Reactor();
+    bool isValid() const;
+
+    int getListenFd() const;
+    int getWakeFd() const;
+    Poller& getPoller();
+    std::vector<Poller::Event>& getEvents();
+    std::vector<int>& getPendingWrites();
+    std::vector<int>& getFlushingWrites();
+    std::vector<SendQueue>& getFlushingQueues();
+    std::thread& getThread();
+
+    void wake();
+    void drainWakeups();
+    bool isWakePending() const;
+    void setWakePending(bool isWakePending);
+
+   private:
+    Reactor(const Reactor& other);
+    Reactor& operator=(const Reactor& other);
+    int listenFd_;
+    int wakePipe_[2];
+    std::unique_ptr<Poller> poller_;
+    std::vector<Poller::Event> events_;
+    std::vector<int> pendingWrites_;         // fds of this reactor's clients with data to send, see Client::setPendingWriteQueue()
+    bool isWakePending_;                     // guarded by the server state mutex like pendingWrites_
+    std::vector<int> flushingWrites_;        // the pending writes being flushed, only touched by the reactor thread
+    std::vector<SendQueue> flushingQueues_;  // their send queues, swapped out to be written without the state mutex
+    std::thread thread_;
+    bool isValid_;
+};
+
+}  // namespace irc
+
+#endif
@@ -25,12 +25,14 @@ namespace irc {
  * and frees the address information structure.
  */
 Server::~Server() {
-    std::map<int, Client>::iterator it = clients_.begin();
-    while (it != clients_.end()) {
-        close(it->first);
-        it++;
+    stopWorkers_();
+    for (Client* client : clients_) {
+        close(client->getFd());
     }
-    close(server_socket_fd_);
+    for (std::unique_ptr<Reactor>& reactor : reactors_) {
+        close(reactor->getListenFd());
+    }
+    reactors_.clear();
     freeaddrinfo(srvinfo_);
 }
 
@@ -40,7 +42,8 @@ Server::~Server() {
  * @param port The port number to bind the server to.
  * @param password The password required to connect to the server.
  */
-Server::Server(char* port, std::string password) : port_(port), password_(password) {}
+Server::Server(char* port, std::string password)
+    : port_(port), password_(password), server_socket_fd_(SOCKET_FAILURE), event_backend_(Poller::getDefaultBackend()), worker_count_(1) {}
 
 /**
  * @brief Sets the server hostname.
@@ -80,13 +83,10 @@ int Server::setServerHostname_() {
  * This function initializes and starts the server by performing the following steps:
  * 1. Calls getaddrinfo() to retrieve address information for the server.
  * 2. Sets the server hostname.
- * 3. Creates a socket using socket().
- * 4. Sets the socket to non-blocking mode using fcntl().
- * 5. Sets the SO_NOSIGPIPE option on the socket using setsockopt() if compiling on MacOS.
- * 6. Binds the socket to the server address using bind().
- * 7. Starts listening for incoming connections using listen().
- * 8. Sets the isServerRunning_g flag to true.
- * 9. Records the start time of the server.
+ * 3. Opens one listening socket per worker (see openListener_()).
+ * 4. Creates one reactor per worker, with its own event backend (poller) watching its listener.
+ * 5. Sets the isServerRunning_g flag to true.
+ * 6. Records the start time of the server.
  * 
  * @return Returns SUCCESS if the server starts successfully, otherwise returns FAILURE.
  */
@@ -106,57 +106,100 @@ int Server::start() {
         return FAILURE;
     }
 
-    server_socket_fd_ = socket(srvinfo_->ai_family, srvinfo_->ai_socktype, server_socket_protocol_);
-    if (server_socket_fd_ == SOCKET_FAILURE) {
-        LOG_ERROR("Server::start: socket creation failed");
-        return FAILURE;
+    for (int i = 0; i < worker_count_; i++) {
+        int listen_fd = openListener_();
+        if (listen_fd == SOCKET_FAILURE) {
+            return FAILURE;
+        }
+        std::unique_ptr<Reactor> reactor(new Reactor(listen_fd, event_backend_));
+        if (reactor->isValid() == false) {
+            LOG_ERROR("Server::start: creating the event loop of worker " << i << " failed");
+            close(listen_fd);
+            return FAILURE;
+        }
+        reactors_.push_back(std::move(reactor));
     }
-    LOG_DEBUG("server socket creation success on fd: " << server_socket_fd_);
+    server_socket_fd_ = reactors_[0]->getListenFd();
+    event_backend_ = reactors_[0]->getPoller().getBackend();
+    LOG_INFO("with event backend " << Poller::getBackendName(event_backend_) << " and " << worker_count_ << " worker(s)");
 
-    // int fcntl_flags = fcntl(server_socket_fd_, F_GETFL);
-    // if (fcntl_flags == FCNTL_FAILURE) {
-    //     LOG_ERROR("Server::start: socket fcntl get flags failed");
-    //     return FAILURE;
-    // }
-    if (fcntl(server_socket_fd_, F_SETFL, O_NONBLOCK) == FCNTL_FAILURE) {  //fcntl_flags | O_NONBLOCK
-        LOG_ERROR("Server::start: socket fcntl set nonblock failed");
-        return FAILURE;
+    isServerRunning_g = true;
+    start_time_ = time(nullptr);
+    return SUCCESS;
+}
+
+/**
+ * @brief Opens a non-blocking listening socket on the server address.
+ * 
+ * 1. Creates a socket using socket().
+ * 2. Sets the socket to non-blocking mode using fcntl().
+ * 3. Sets the SO_REUSEADDR option, SO_REUSEPORT with several workers, and SO_NOSIGPIPE if compiling on MacOS.
+ * 4. Binds the socket to the server address using bind().
+ * 5. Starts listening for incoming connections using listen().
+ * 
+ * With SO_REUSEPORT every worker binds its own socket to the same port, and the kernel
+ * spreads the incoming connections over them.
+ * 
+ * @return The listening socket, or SOCKET_FAILURE.
+ */
+int Server::openListener_() {
+    int listen_fd = socket(srvinfo_->ai_family, srvinfo_->ai_socktype, server_socket_protocol_);
+    if (listen_fd == SOCKET_FAILURE) {
+        LOG_ERROR("Server::openListener_: socket creation failed");
+        return SOCKET_FAILURE;
     }
-    LOG_DEBUG("Server::start: socket fcntl nonblock success");
+    LOG_DEBUG("server socket creation success on fd: " << listen_fd);
 
-    if (ON_MACOS) {
-        int optval = TRUE;
-        if (setsockopt(server_socket_fd_, SOL_SOCKET, SO_NOSIGPIPE, &optval, sizeof(optval)) == SETSOCKOPT_FAILURE) {
-            LOG_ERROR("Server::start: socket setsockopt failed: " << strerror(errno));
-            return FAILURE;
-        }
-        LOG_DEBUG("Server::start: socket setsockopt success");
+    if (fcntl(listen_fd, F_SETFL, O_NONBLOCK) == FCNTL_FAILURE || fcntl(listen_fd, F_SETFD, FD_CLOEXEC) == FCNTL_FAILURE) {
+        LOG_ERROR("Server::openListener_: socket fcntl set nonblock failed");
+        close(listen_fd);
+        return SOCKET_FAILURE;
     }
+    LOG_DEBUG("Server::openListener_: socket fcntl nonblock success");
 
-    if (bind(server_socket_fd_, srvinfo_->ai_addr, srvinfo_->ai_addrlen) == BIND_FAILURE) {
-        LOG_ERROR("Server::start: bind failed: " << strerror(errno));
-        return FAILURE;
+    int optval = TRUE;
+    if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) == SETSOCKOPT_FAILURE) {
+        LOG_ERROR("Server::openListener_: socket setsockopt SO_REUSEADDR failed: " << strerror(errno));
+        close(listen_fd);
+        return SOCKET_FAILURE;
+    }
+    if (worker_count_ > 1 && setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) == SETSOCKOPT_FAILURE) {
+        LOG_ERROR("Server::openListener_: socket setsockopt SO_REUSEPORT failed: " << strerror(errno));
+        close(listen_fd);
+        return SOCKET_FAILURE;
+    }
+    if (ON_MACOS && setsockopt(listen_fd, SOL_SOCKET, SO_NOSIGPIPE, &optval, sizeof(optval)) == SETSOCKOPT_FAILURE) {
+        LOG_ERROR("Server::openListener_: socket setsockopt failed: " << strerror(errno));
+        close(listen_fd);
+        return SOCKET_FAILURE;
     }
-    LOG_DEBUG("Server::start: bind success");
 
-    if (listen(server_socket_fd_, SOMAXCONN) == LISTEN_FAILURE) {
-        LOG_ERROR("Server::start: listen failed");
-        return FAILURE;
+    if (bind(listen_fd, srvinfo_->ai_addr, srvinfo_->ai_addrlen) == BIND_FAILURE) {
+        LOG_ERROR("Server::openListener_: bind failed: " << strerror(errno));
+        close(listen_fd);
+        return SOCKET_FAILURE;
     }
-    LOG_DEBUG("Server::start: listen success");
+    LOG_DEBUG("Server::openListener_: bind success");
 
-    isServerRunning_g = true;
-    start_time_ = time(nullptr);
-    return SUCCESS;
+    if (listen(listen_fd, SOMAXCONN) == LISTEN_FAILURE) {
+        LOG_ERROR("Server::openListener_: listen failed");
+        close(listen_fd);
+        return SOCKET_FAILURE;
+    }
+    LOG_DEBUG("Server::openListener_: listen success");
+    return listen_fd;
 }
 
 /**
  * @brief Executes the main loop of the IRC server.
  * 
- * This function continuously polls for events on the server socket and client sockets,
+ * This function continuously waits for events on the server socket and client sockets,
  * and handles the corresponding actions based on the received events.
  * 
  * @details The loop runs until the server is stopped by setting the `isServerRunning_g` flag to false.
+ * With several workers, reactor 0 runs on the calling thread and every other reactor on a thread
+ * of its own. The worker threads block all signals, so a signal always interrupts the calling
+ * thread, which then stops and joins the workers.
  * 
  * @throws std::runtime_error if the server poll fails.
  * 
@@ -166,228 +209,553 @@ int Server::start() {
  * @note The function also logs debug messages for various events during the server loop.
  */
 void Server::loop() {
-    std::vector<pollfd> pollfds;
-    pollfd server_pollfd;
-    server_pollfd.fd = server_socket_fd_;
-    server_pollfd.events = POLLIN | POLLERR;
-    pollfds.push_back(server_pollfd);
-
     LOG_DEBUG("Server::loop: loop start")
-    while (isServerRunning_g) {
-        std::vector<pollfd> tmp_pollfds;
+    sigset_t allSignals;
+    sigset_t previousSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_BLOCK, &allSignals, &previousSignals);  // inherited by the worker threads
+    for (unsigned long i = 1; i < reactors_.size(); i++) {
+        reactors_[i]->getThread() = std::thread(&Server::runWorker_, this, reactors_[i].get());
+    }
+    pthread_sigmask(SIG_SETMASK, &previousSignals, NULL);
+    try {
+        while (isServerRunning_g) {
+            loopOnce_(*reactors_[0], POLLER_WAIT_INFINITE);
+        }
+    } catch (std::exception& e) {
+        stopWorkers_();
+        throw;
+    }
+    stopWorkers_();
+    LOG_DEBUG("Server::loop: loop end")
+}
 
-        if (poll(pollfds.data(), static_cast<unsigned int>(pollfds.size()), -1) == POLL_FAILURE) {
-            if (errno == EINTR && isServerRunning_g == false) {
-                continue;
-            }
+/**
+ * @brief Runs the event loop of one worker thread until the server stops.
+ */
+void Server::runWorker_(Reactor* reactor) {
+    LOG_DEBUG("Server::runWorker_: worker for listener fd " << reactor->getListenFd() << " started");
+    try {
+        while (isServerRunning_g) {
+            loopOnce_(*reactor, POLLER_WAIT_INFINITE);
+        }
+    } catch (std::exception& e) {
+        LOG_ERROR("Server::runWorker_: Exception: " << e.what());
+        stop();
+    }
+}
+
+/**
+ * @brief Stops the server loop, callable from any thread.
+ */
+void Server::stop() {
+    isServerRunning_g = false;
+    for (std::unique_ptr<Reactor>& reactor : reactors_) {
+        reactor->wake();
+    }
+}
+
+void Server::stopWorkers_() {
+    isServerRunning_g = false;
+    for (std::unique_ptr<Reactor>& reactor : reactors_) {
+        if (reactor->getThread().joinable()) {
+            reactor->wake();
+            reactor->getThread().join();
+        }
+    }
+}
+
+/**
+ * @brief Runs one iteration of the first reactor's event loop on the calling thread.
+ * 
+ * The other reactors are only served by loop(), this is meant for single-worker servers and tests.
+ * 
+ * @param timeoutMs Maximum time to wait for events, or POLLER_WAIT_INFINITE.
+ * @throws std::runtime_error if the server poll fails.
+ */
+void Server::loopOnce(int timeoutMs) {
+    loopOnce_(*reactors_[0], timeoutMs);
+}
+
+/**
+ * @brief Waits once for events and handles every ready descriptor reported by the poller of reactor.
+ * 
+ * Only the ready descriptors are visited, so the cost of one iteration scales
+ * with the amount of activity instead of the amount of connected clients.
+ * 
+ * Clients are never removed while the events are handled: a client that has to go is
+ * only marked (see deferDisconnect_()) and removed after its last replies are flushed at
+ * the end of the iteration. Its fd therefore stays open and cannot be reused by an accept
+ * within the same batch, and every other ready descriptor of this wakeup is still handled.
+ * 
+ * Clients, channels and send queues are shared by all reactors and only touched with
+ * state_mutex_ held. Waiting, accepting and receiving into the client's own receive buffer,
+ * which no other reactor touches, happen without it, and so do framing, parsing, the commands
+ * that only touch their sender (see executeReceived_()) and the writes to the sockets
+ * (see flushPendingWrites_()).
+ * 
+ * @param reactor The reactor to run, owned by the calling thread.
+ * @param timeoutMs Maximum time to wait for events, or POLLER_WAIT_INFINITE.
+ * @throws std::runtime_error if the server poll fails.
+ */
+void Server::loopOnce_(Reactor& reactor, int timeoutMs) {
+    std::vector<Poller::Event>& events = reactor.getEvents();
+    while (reactor.getPoller().wait(events, timeoutMs) == POLL_FAILURE) {
+        // Only a stopping server ends the iteration early, other interruptions (such as
+        // the kernel cleaning up a closed io_uring instance) wait again
+        if (errno == EINTR && isServerRunning_g == false) {
+            return;
+        }
+        if (errno != EINTR) {
             throw std::runtime_error("Server::loop: poll failed");
         }
+    }
 
-        std::vector<pollfd>::iterator it = pollfds.begin();
-        while (it != pollfds.end()) {
-            if (it->revents & POLLIN) {
-                if (it->fd == server_socket_fd_) {
-                    if (acceptClient_(tmp_pollfds) == ACCEPT_FAILURE) {
-                        continue;
-                    }
-                } else {
-                    try {
-                        Client& client = clients_.at(it->fd);
-                        recvToBuffer_(client);
-                        if (client.getWantDisconnect() == true) {
-                            disconnectClient_(pollfds, it);
-                            break;
-                        }
-                        std::string messageString;
-                        while (extractMessageString_(messageString, client) != FAILURE) {
-                            Message message(messageString);
-                            if (message.getNumeric() != SUCCESS) {
-                                LOG_DEBUG("Server::loop: got malformed message from client on fd " << client.getFd() << ": "
-                                                                                                   << messageString);
-                                handleMalformedMessage_(client, message);
-                                continue;
-                            }
-                            LOG_DEBUG("Server::loop: received message from client on fd " << client.getFd() << ": " << messageString);
-                            try {
-                                Command command(message, client, clients_, password_, start_time_, channels_);
-                            } catch (std::invalid_argument& e) {
-                                LOG_ERROR("Server::loop: invalid argument exception for fd " << it->fd << ": " << e.what());
-                            }
-                            client.processErrorMessage();
-                        }
-                    } catch (std::out_of_range& e) {
-                        LOG_ERROR("Server::loop: out of range exception for fd " << it->fd << ": " << e.what());
-                        disconnectClient_(pollfds, it);
-                        break;
-                    }
-                }
+    for (Poller::Event& event : events) {
+        if (event.fd == reactor.getListenFd()) {
+            if (event.error) {
+                throw std::runtime_error("Server::loop: socket pollerr");
             }
-            if (it->revents & POLLOUT) {
-                try {
-                    Client& client = clients_.at(it->fd);
-                    sendFromBuffer_(client);  //logs nothing if sendbuffer is empty
-                    if (client.getWantDisconnect() == true) {
-                        disconnectClient_(pollfds, it);
-                        break;
-                    }
-                } catch (std::out_of_range& e) {
-                    LOG_ERROR("Server::loop: client object not found for POLLOUT at fd " << it->fd << ": " << e.what());
-                    disconnectClient_(pollfds, it);
-                    break;
-                }
+            if (event.completed) {
+                addAcceptedClient_(reactor, static_cast<int>(event.result));
+            } else {
+                acceptClients_(reactor);
             }
-            if (it->revents & POLLERR) {
-                if (it->fd == server_socket_fd_) {
-                    throw std::runtime_error("Server::loop: socket pollerr");
-                } else {
-                    disconnectClient_(pollfds, it);
-                    break;
-                }
+            continue;
+        }
+        if (event.fd == reactor.getWakeFd()) {
+            reactor.drainWakeups();
+            continue;
+        }
+        Client* clientOrNull;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            clientOrNull = clients_.getOrNull(event.fd);
+        }
+        if (clientOrNull == nullptr) {
+            LOG_WARNING("Server::loop: no client found for event on fd " << event.fd << ", unregistering it");
+            reactor.getPoller().remove(event.fd);
+            continue;
+        }
+        Client& client = *clientOrNull;  // only this reactor erases its clients
+        std::unique_lock<std::mutex> lock(state_mutex_, std::defer_lock);
+        if (event.readable) {
+            long long recv_ret = event.completed ? appendReceived_(client, event) : recvToBuffer_(client);
+            if (client.getWantDisconnect() == false) {
+                executeReceived_(client, recv_ret, lock);
             }
-            it++;
         }
+        if (lock.owns_lock() == false) {
+            lock.lock();
+        }
+        if (event.error) {
+            deferDisconnect_(client, "Connection error");
+        }
+        // Written at the end of the iteration, a client that has to go is disconnected after its last replies
+        if (event.writable || client.getWantDisconnect() == true) {
+            reactor.getPendingWrites().push_back(event.fd);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    flushPendingWrites_(reactor, lock);
+    wakeOtherReactors_(reactor);
+}
+
+/**
+ * @brief Executes the complete messages in the receive buffer of the client.
+ * 
+ * The lines are framed and parsed without state_mutex_, and so are the commands that only touch
+ * the client (see Command::isSenderOnly()), e.g. registration and PING. Their replies are kept
+ * apart from the data other reactors queue for the client meanwhile, and merged in order before
+ * the next command that needs the lock and at the end. The lock is only held while a command
+ * that reaches other clients or channels executes.
+ * 
+ * @param client The client whose socket was read.
+ * @param recv_ret The result of recvToBuffer_() for the client.
+ * @param lock Does not hold state_mutex_ when called, holds it when returning.
+ */
+void Server::executeReceived_(Client& client, long long recv_ret, std::unique_lock<std::mutex>& lock) {
+    RecvBuffer::Line line;
+    client.deferReplies();
+    while (extractMessageLine_(line, client) != FAILURE) {
+        Message message(line);
+        if (message.getNumeric() != SUCCESS) {
+            LOG_DEBUG("Server::loop: got malformed message from client on fd " << client.getFd() << ": " << std::string(line.data, line.length));
+            handleMalformedMessage_(client, message);
+            continue;
+        }
+        LOG_DEBUG("Server::loop: received message from client on fd " << client.getFd() << ": " << std::string(line.data, line.length));
+        bool isSenderOnly = Command::isSenderOnly(message, client);
+        if (isSenderOnly == false) {
+            lock.lock();
+            client.mergeDeferredReplies();
+        }
+        try {
+            Command command(message, client, clients_, password_, start_time_, channels_);
+        } catch (std::invalid_argument& e) {
+            LOG_ERROR("Server::loop: invalid argument exception for fd " << client.getFd() << ": " << e.what());
+        }
+        client.processErrorMessage();
+        if (isSenderOnly == false) {
+            lock.unlock();
+            client.deferReplies();
+        }
+    }
+    // The messages received before the shutdown are handled and answered first
+    if (recv_ret == RECV_ORDERLY_SHUTDOWN) {
+        deferDisconnect_(client, "Client closed connection");
+    } else if (recv_ret == RECV_FAILURE) {
+        deferDisconnect_(client, "Read error");
+    }
+    lock.lock();
+    client.mergeDeferredReplies();
+}
 
-        pollfds.insert(pollfds.end(), tmp_pollfds.begin(), tmp_pollfds.end());
+/**
+ * @brief Marks the client for disconnection at the end of the current loop iteration.
+ * 
+ * The client stays in clients_ and its fd stays open until flushPendingWrites_()
+ * has sent its last replies, then it is removed by disconnectClient_().
+ * 
+ * @param client The client to disconnect.
+ * @param reason The QUIT reason, used only if the client did not give one already.
+ */
+void Server::deferDisconnect_(Client& client, const std::string& reason) {
+    if (client.getDisconnectReason().empty()) {
+        client.setDisconnectReason(reason);
     }
-    LOG_DEBUG("Server::loop: loop end")
+    client.setWantDisconnect();
 }
 
 /**
- * Accepts a new client connection and adds it to the server's list of clients.
+ * @brief Sends the data queued for the clients of reactor without waiting for POLLOUT.
  * 
- * @param pollfds A reference to the vector of pollfds used for polling events.
- * @return The file descriptor of the newly accepted client, or ACCEPT_FAILURE if an error occurred.
+ * Clients announce themselves in the pending writes of their reactor when data is appended to
+ * an empty send queue. Most replies fit into the socket buffer right away, so write interest is
+ * only armed for the clients that still have data left after this attempt, and disarmed again once
+ * they are drained. This keeps an idle server from waking up for sockets that are always writable.
+ * 
+ * The sockets are written without state_mutex_, so the other reactors keep executing commands
+ * meanwhile: the send queues of the announced clients are swapped out under the lock, sent after
+ * releasing it, and what did not fit is put back in front of the data queued in the meantime.
+ * The clients cannot go away while the lock is released, only this reactor disconnects them.
+ * 
+ * @param reactor The reactor owning the clients.
+ * @param lock Holds state_mutex_ when called and when returning, it is released while sending.
  */
-int Server::acceptClient_(std::vector<pollfd>& pollfds) {
-    pollfd client_pollfd;
+void Server::flushPendingWrites_(Reactor& reactor, std::unique_lock<std::mutex>& lock) {
+    std::vector<int>& pendingWrites = reactor.getPendingWrites();
+    std::vector<int>& flushing = reactor.getFlushingWrites();
+    std::vector<SendQueue>& queues = reactor.getFlushingQueues();
+    // Disconnecting a client may queue QUIT messages for others, they are flushed in another round
+    bool hasDisconnected = true;
+    while (hasDisconnected && pendingWrites.empty() == false) {
+        reactor.setWakePending(false);
+        flushing.swap(pendingWrites);
+        if (queues.size() < flushing.size()) {
+            queues.resize(flushing.size());
+        }
+        for (unsigned long i = 0; i < flushing.size(); i++) {
+            Client* clientOrNull = clients_.getOrNull(flushing[i]);
+            if (clientOrNull != nullptr) {
+                clientOrNull->unschedulePendingWrite();
+                queues[i].swap(clientOrNull->getSendQueue());
+            }
+        }
+
+        lock.unlock();
+        for (unsigned long i = 0; i < flushing.size(); i++) {
+            sendFromBuffer_(reactor, flushing[i], queues[i]);  // logs nothing if the queue is empty
+        }
+        lock.lock();
+
+        hasDisconnected = false;
+        for (unsigned long i = 0; i < flushing.size(); i++) {
+            Client* clientOrNull = clients_.getOrNull(flushing[i]);
+            if (clientOrNull == nullptr) {
+                queues[i].clear();
+                continue;
+            }
+            Client& client = *clientOrNull;
+            client.getSendQueue().prepend(queues[i]);
+            if (client.getWantDisconnect() == true) {
+                disconnectClient_(reactor, flushing[i]);
+                hasDisconnected = true;
+                continue;
+            }
+            updateWriteInterest_(reactor, client);
+        }
+        flushing.clear();
+    }
+}
+
+/**
+ * @brief Wakes the reactors that got data queued for their clients by this one.
+ * 
+ * Must be called with state_mutex_ held.
+ */
+void Server::wakeOtherReactors_(Reactor& reactor) {
+    for (std::unique_ptr<Reactor>& other : reactors_) {
+        if (other.get() != &reactor && other->getPendingWrites().empty() == false && other->isWakePending() == false) {
+            other->setWakePending(true);
+            other->wake();
+        }
+    }
+}
+
+/**
+ * @brief Arms write interest if the client still has data to send, disarms it otherwise.
+ * 
+ * @param reactor The reactor owning the client.
+ * @param client The client whose registration in the poller is updated.
+ */
+void Server::updateWriteInterest_(Reactor& reactor, Client& client) {
+    bool wantWrite = client.getSendQueue().empty() == false;
+    if (wantWrite == client.isWriteInterestArmed()) {
+        return;
+    }
+    if (reactor.getPoller().modify(client.getFd(), wantWrite) == SUCCESS) {
+        client.setWriteInterestArmed(wantWrite);
+        LOG_DEBUG("Server::updateWriteInterest_: write interest " << (wantWrite ? "armed" : "disarmed") << " for fd " << client.getFd());
+    }
+}
+
+/**
+ * Accepts the pending connections of the listen backlog of reactor until it is empty (EAGAIN).
+ * 
+ * The sockets are created non-blocking and close-on-exec by accept4() where available,
+ * other platforms set the flags with fcntl(). At most SERVER_ACCEPT_BUDGET_PER_EVENT
+ * connections are accepted per event so the connected clients are still served during
+ * a reconnect storm, the rest of the backlog is reported again by the (level-triggered) poller.
+ * 
+ * @return The number of accepted clients.
+ */
+int Server::acceptClients_(Reactor& reactor) {
+    int accepted = 0;
+    for (int attempt = 0; attempt < SERVER_ACCEPT_BUDGET_PER_EVENT; attempt++) {
+        struct sockaddr client_info;
+        socklen_t client_info_length = sizeof client_info;
+#if HAVE_ACCEPT4
+        int new_client_fd = accept4(reactor.getListenFd(), &client_info, &client_info_length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int new_client_fd = accept(reactor.getListenFd(), &client_info, &client_info_length);
+#endif
+        if (new_client_fd == ACCEPT_FAILURE) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("Server::acceptClients_: failed to accept new client connection: " << strerror(errno));
+            }
+            break;
+        }
+        if (addClient_(reactor, new_client_fd, client_info) == SUCCESS) {
+            accepted++;
+        }
+    }
+    LOG_DEBUG("Server::acceptClients_: accepted " << accepted << " clients");
+    return accepted;
+}
+
+/**
+ * Adds a connection the poller already accepted (completion-based backends),
+ * the address of the peer is looked up with getpeername().
+ * 
+ * @return SUCCESS if the client was added, FAILURE otherwise.
+ */
+int Server::addAcceptedClient_(Reactor& reactor, int new_client_fd) {
     struct sockaddr client_info;
-    unsigned int client_info_length = sizeof client_info;
-    int new_client_fd = accept(server_socket_fd_, &client_info, &client_info_length);
-    if (new_client_fd == ACCEPT_FAILURE) {
-        LOG_ERROR("Server::acceptClient_: failed to accept new client connection: " << strerror(errno));
-        return ACCEPT_FAILURE;
-    }
-    clients_.insert(std::make_pair(new_client_fd, Client(new_client_fd, client_info)));
-    client_pollfd.fd = new_client_fd;
-    client_pollfd.events = POLLIN | POLLOUT | POLLERR;
-    pollfds.push_back(client_pollfd);
+    socklen_t client_info_length = sizeof client_info;
+    if (getpeername(new_client_fd, &client_info, &client_info_length) == GETPEERNAME_FAILURE) {
+        LOG_ERROR("Server::addAcceptedClient_: getpeername failed for fd " << new_client_fd << ": " << strerror(errno));
+        close(new_client_fd);
+        return FAILURE;
+    }
+    return addClient_(reactor, new_client_fd, client_info);
+}
+
+/**
+ * Adds a newly accepted client connection to the server's list of clients
+ * and registers it to the poller of reactor, so it takes part in the very next wait.
+ * 
+ * @param reactor The reactor that accepted the client and will serve it.
+ * @param new_client_fd The accepted socket, closed if it cannot be added.
+ * @param client_info The address of the peer.
+ * @return SUCCESS if the client was added, FAILURE otherwise.
+ */
+int Server::addClient_(Reactor& reactor, int new_client_fd, const struct sockaddr& client_info) {
+#if !HAVE_ACCEPT4
+    if (fcntl(new_client_fd, F_SETFL, O_NONBLOCK) == FCNTL_FAILURE || fcntl(new_client_fd, F_SETFD, FD_CLOEXEC) == FCNTL_FAILURE) {
+        LOG_ERROR("Server::addClient_: fcntl set nonblock failed for fd " << new_client_fd << ": " << strerror(errno));
+        close(new_client_fd);
+        return FAILURE;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    Client* client = clients_.insert(new_client_fd, Client(new_client_fd, client_info));
+    if (client == nullptr) {
+        close(new_client_fd);
+        return FAILURE;
+    }
+    client->setPendingWriteQueue(&reactor.getPendingWrites());
+    if (reactor.getPoller().addConnection(new_client_fd) == FAILURE) {
+        LOG_ERROR("Server::addClient_: failed to register new client on fd " << new_client_fd << " to the poller");
+        clients_.erase(new_client_fd);
+        close(new_client_fd);
+        return FAILURE;
+    }
     LOG_INFO("Clients on server: " << clients_.size() << " (new client connected on fd " << new_client_fd << ")");
-    return new_client_fd;
+    return SUCCESS;
 }
 
 /**
  * @brief Disconnects a client from the server.
  * 
- * This function disconnects a client from the server by closing its file descriptor,
- * removing it from the clients_ map, removing it from it's channels,
- * and erasing it from the poll_fds vector.
+ * This function disconnects a client from the server by removing it from it's channels and from
+ * clients_, unregistering it from the poller of its reactor and closing its file descriptor.
+ * The fd is closed last, once no other reactor can find the client under that fd anymore.
+ * Must be called with state_mutex_ held.
  * 
- * @param poll_fds The vector of pollfd structures representing the active file descriptors.
- * @param it An iterator pointing to the pollfd structure of the client to be disconnected.
+ * @param reactor The reactor owning the client.
+ * @param client_fd The file descriptor of the client to be disconnected.
  * @return int Returns SUCCESS if the client was successfully disconnected.
  * Otherwise, returns FAILURE.
  */
-int Server::disconnectClient_(std::vector<pollfd>& poll_fds, std::vector<pollfd>::iterator& it) {
-    int client_fd = it->fd;
-    Client client = clients_.at(client_fd);
-
-    // Close client file descriptor
+int Server::disconnectClient_(Reactor& reactor, int client_fd) {
+    Client* clientOrNull = clients_.getOrNull(client_fd);
+    if (clientOrNull == nullptr) {
+        LOG_WARNING("Server::disconnectClient_: client not found at fd " << client_fd);
+        return FAILURE;
+    }
+    Client& client = *clientOrNull;
     LOG_DEBUG("Server::disconnectClient_: disconnecting client on fd " << client_fd);
-    close(client_fd);
 
-    // Remove client from it's channels, and send QUIT messages
-    std::vector<std::string> channelNames = client.getMyChannels();
+    // Send the QUIT message once to everyone sharing a channel with the client, then remove it from its channels
+    std::vector<Channel*> channels = client.getMyChannels();  // parting changes the client's list
     std::string reason = client.getDisconnectReason();
-    for (std::string channelName : channelNames) {
-        Channel& channel = channels_.at(channelName);
-        channel.sendMessageToMembersExcluding(
-            COM_MESSAGE(client.getNickname(), client.getUserName(), client.getHost(), "QUIT", ":" + reason), client);
-        channel.partMember(client);
+    if (channels.empty() == false) {
+        SharedPayload quitMessage = std::make_shared<const std::string>(PREFIXED_MESSAGE(client.getPrefix(), "QUIT", ":", reason).toString());
+        Channel::sendMessageToNeighbours(client, quitMessage);
     }
-
-    unsigned long clients_erased = clients_.erase(client_fd);
-    if (clients_erased == 0) {
-        LOG_WARNING("Server::disconnectClient_: client not found at fd " << client_fd << " to erase from clients_ map");
-        return FAILURE;
+    for (Channel* channel : channels) {
+        channel->partMember(client);
     }
 
-    // Erase client from poll_fds (the poll loop vector)
-    poll_fds.erase(it);
+    clients_.erase(client_fd);
+
+    // Unregister from the poller and close client file descriptor
+    reactor.getPoller().remove(client_fd);
+    close(client_fd);
+
     LOG_INFO("Clients on server: " << clients_.size() << " (client disconnected on fd " << client_fd << ")");
     return SUCCESS;
 }
 
 /**
- * Sends data from the send buffer to the client.
+ * Sends data from a send queue to a client.
  * 
- * This function sends the data stored in the send buffer of the specified client
- * to the client's file descriptor using the send system call. It returns the number
- * of bytes sent on success, or an error code on failure.
+ * Up to SEND_QUEUE_MAX_IOVECS chunks of the queue are handed to a single Poller::send() call,
+ * a sendmsg() (a writev() that accepts MSG_NOSIGNAL) or a queued io_uring send. It returns
+ * the number of bytes sent on success (0 if the socket buffer is full), or an error code on failure.
+ * A partial write only advances the queue, the unsent data is not moved.
+ * Called without state_mutex_, queue is swapped out of the client by flushPendingWrites_().
  * 
- * @param client The client object representing the connected client.
+ * @param reactor The reactor owning the client.
+ * @param client_fd The socket of the client.
+ * @param queue The data to send to the client.
  * @return The number of bytes sent on success, or an error code on failure.
  */
-long long Server::sendFromBuffer_(Client& client) {
-    std::string& buffer = client.getSendBuffer();
-    if (buffer.empty()) {
+long long Server::sendFromBuffer_(Reactor& reactor, int client_fd, SendQueue& queue) {
+    if (queue.empty()) {
         return SUCCESS;
     }
-    long long send_ret = send(client.getFd(), buffer.c_str(), buffer.size(), MSG_NOSIGNAL);
+    struct iovec iovecs[SEND_QUEUE_MAX_IOVECS];
+    int iovecCount = queue.gather(iovecs, SEND_QUEUE_MAX_IOVECS);
+    long long send_ret = reactor.getPoller().send(client_fd, iovecs, iovecCount);
+    if (send_ret == SEND_FAILURE && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        LOG_DEBUG("Server::sendFromBuffer_: socket buffer full for client on fd " << client_fd);
+        return 0;
+    }
     if (send_ret == SEND_FAILURE) {
         LOG_ERROR("Server::sendFromBuffer_: send failed: " << strerror(errno));
         return SEND_FAILURE;
     }
-    LOG_DEBUG("Server::sendFromBuffer_: sent " << send_ret << " bytes to client on fd " << client.getFd());
-    buffer.erase(0, static_cast<unsigned long>(send_ret));
+    LOG_DEBUG("Server::sendFromBuffer_: sent " << send_ret << " bytes to client on fd " << client_fd);
+    queue.consume(static_cast<unsigned long>(send_ret));
     return send_ret;
 }
 
 /**
- * Receives data from the client and appends it to the receive buffer of the specified client.
+ * Appends the data a completion-based poller already received for the client to its receive buffer.
+ * 
+ * @param client The client the data was received from.
+ * @param event The completed receive reported by the poller.
+ * @return The number of bytes received, or RECV_ORDERLY_SHUTDOWN if the client disconnected gracefully.
+ */
+long long Server::appendReceived_(Client& client, const Poller::Event& event) {
+    if (event.result == RECV_ORDERLY_SHUTDOWN) {
+        LOG_DEBUG("Server::appendReceived_: client on fd " << client.getFd() << " disconnected gracefully");
+        return RECV_ORDERLY_SHUTDOWN;
+    }
+    RecvBuffer& buf = client.getRecvBuffer();
+    unsigned long length = static_cast<unsigned long>(event.result);
+    memcpy(buf.prepare(length), event.data, length);
+    buf.commit(length);
+    LOG_DEBUG("Server::appendReceived_: received " << event.result << " bytes from client on fd " << client.getFd());
+    return event.result;
+}
+
+/**
+ * Receives data from the client directly into the receive buffer of the specified client.
+ * 
+ * The socket is read until it has no more data (EAGAIN), so a burst is handled within one
+ * loop iteration. SERVER_RECV_BUDGET_PER_EVENT bounds the amount read per event to keep the
+ * server fair to other clients, the rest is reported again by the (level-triggered) poller.
  * 
  * @param client The client to receive data from.
  * @return The number of bytes received, or RECV_FAILURE if an error occurred,
  * or RECV_ORDERLY_SHUTDOWN if the client disconnected gracefully.
  */
 long long Server::recvToBuffer_(Client& client) {
-    char tmpRecvBuffer[SERVER_RECV_BUFFER_SIZE];
-    long long recv_ret = RECV_FAILURE;
-    std::string& buf = client.getRecvBuffer();
-
-    memset(tmpRecvBuffer, 0, SERVER_RECV_BUFFER_SIZE);
-    recv_ret = recv(client.getFd(), tmpRecvBuffer, SERVER_RECV_BUFFER_SIZE, 0);
-    if (recv_ret == RECV_FAILURE) {
-        LOG_ERROR("Server::recvToBuffer_: recv failed on fd: " << client.getFd() << " with: " << strerror(errno));
-        return RECV_FAILURE;
-    }
-    if (recv_ret == RECV_ORDERLY_SHUTDOWN) {
-        LOG_DEBUG("Server::recvToBuffer_: client on fd " << client.getFd() << " disconnected gracefully");
-        client.setDisconnectReason("Client closed connection");
-        client.setWantDisconnect();
-        return RECV_ORDERLY_SHUTDOWN;
+    RecvBuffer& buf = client.getRecvBuffer();
+    long long total_received = 0;
+
+    while (total_received < SERVER_RECV_BUDGET_PER_EVENT) {
+        char* destination = buf.prepare(SERVER_RECV_BUFFER_SIZE);
+        long long recv_ret = recv(client.getFd(), destination, buf.getWritableSize(), 0);
+        if (recv_ret == RECV_FAILURE) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            LOG_ERROR("Server::recvToBuffer_: recv failed on fd: " << client.getFd() << " with: " << strerror(errno));
+            return RECV_FAILURE;
+        }
+        if (recv_ret == RECV_ORDERLY_SHUTDOWN) {
+            LOG_DEBUG("Server::recvToBuffer_: client on fd " << client.getFd() << " disconnected gracefully");
+            return RECV_ORDERLY_SHUTDOWN;
+        }
+        buf.commit(static_cast<unsigned long>(recv_ret));
+        total_received += recv_ret;
     }
-    LOG_DEBUG("Server::recvToBuffer_: received a packet of " << recv_ret << " bytes from client on fd " << client.getFd());
-    buf.append(tmpRecvBuffer, static_cast<unsigned long>(recv_ret));
-    return recv_ret;
+    LOG_DEBUG("Server::recvToBuffer_: received " << total_received << " bytes from client on fd " << client.getFd());
+    return total_received;
 }
 
 /**
- * Extracts a complete message string from the receive buffer of a client.
+ * Extracts a complete message line from the receive buffer of a client.
  * 
- * @param message The extracted message string. (destination)
+ * @param line A view of the extracted line, valid until the buffer is written to. (destination)
  * @param client The client from which to extract the message.
  * @return Returns SUCCESS if a complete message is extracted, FAILURE otherwise.
  */
-int Server::extractMessageString_(std::string& message, Client& client) {
-    std::string& buf = client.getRecvBuffer();
-    std::string pattern = "\r\n";
-    std::string::size_type pos = buf.find(pattern);
-    if (pos == std::string::npos) {
+int Server::extractMessageLine_(RecvBuffer::Line& line, Client& client) {
+    if (client.getRecvBuffer().nextLine(line) == false) {
         return FAILURE;
     }
-    message.clear();
-    message = buf.substr(0, pos);
-    buf.erase(0, pos + pattern.length());
     return SUCCESS;
 }
 
@@ -410,6 +778,15 @@ void Server::handleMalformedMessage_(Client& client, Message& message) {
     }
 }
 
+/**
+ * @brief Selects the event backend, must be called before start().
+ * 
+ * @param backend The preferred backend, poll is used as a fallback if it is not available.
+ */
+void Server::setEventBackend(Poller::Backend backend) {
+    event_backend_ = backend;
+}
+
 // Getter functions
 
 char* Server::getPort() {
@@ -440,6 +817,33 @@ struct addrinfo& Server::getServerInfo() {
     return *srvinfo_;
 }
 
+Poller::Backend Server::getEventBackend() {
+    return event_backend_;
+}
+
+/**
+ * @brief Sets the amount of reactor threads, must be called before start().
+ * 
+ * @param workerCount Between 1 and SERVER_MAX_WORKERS.
+ * @return int SUCCESS, or FAILURE if the count is out of range.
+ */
+int Server::setWorkerCount(int workerCount) {
+    if (workerCount < 1 || workerCount > SERVER_MAX_WORKERS) {
+        return FAILURE;
+    }
+    worker_count_ = workerCount;
+    return SUCCESS;
+}
+
+int Server::getWorkerCount() const {
+    return worker_count_;
+}
+
+unsigned long Server::getClientCount() {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    return clients_.size();
+}
+
 std::string Server::getStartTimeString() {
     return std::string(ctime(&start_time_));
 }
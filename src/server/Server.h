@@ -4,16 +4,21 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <netdb.h>
-#include <sys/poll.h>
+#include <pthread.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <csignal>
 #include <cstring>
 #include <ctime>
-#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../common/log.h"
@@ -21,11 +26,15 @@
 #include "../common/os.h"
 
 #include "../channel/Channel.h"
+#include "../channel/ChannelTable.h"
 #include "../client/Client.h"
+#include "../client/ClientTable.h"
 #include "../command/Command.h"
 #include "../message/Message.h"
+#include "../poller/Poller.h"
+#include "Reactor.h"
 
-extern bool isServerRunning_g;
+extern std::atomic<bool> isServerRunning_g;
 extern std::string serverHostname_g;
 
 namespace irc {
@@ -41,11 +50,23 @@ namespace irc {
 class Server {
    private:
     int setServerHostname_();
-    int acceptClient_(std::vector<pollfd>& pollfds);
-    int disconnectClient_(std::vector<pollfd>& poll_fds, std::vector<pollfd>::iterator& it);
-    long long sendFromBuffer_(Client& client);
+    int openListener_();
+    void runWorker_(Reactor* reactor);
+    void stopWorkers_();
+    void loopOnce_(Reactor& reactor, int timeoutMs);
+    int acceptClients_(Reactor& reactor);
+    int addClient_(Reactor& reactor, int new_client_fd, const struct sockaddr& client_info);
+    int addAcceptedClient_(Reactor& reactor, int new_client_fd);
+    void executeReceived_(Client& client, long long recv_ret, std::unique_lock<std::mutex>& lock);
+    void deferDisconnect_(Client& client, const std::string& reason);
+    int disconnectClient_(Reactor& reactor, int client_fd);
+    long long sendFromBuffer_(Reactor& reactor, int client_fd, SendQueue& queue);
+    void flushPendingWrites_(Reactor& reactor, std::unique_lock<std::mutex>& lock);
+    void wakeOtherReactors_(Reactor& reactor);
+    void updateWriteInterest_(Reactor& reactor, Client& client);
     long long recvToBuffer_(Client& client);
-    int extractMessageString_(std::string& message, Client& client);
+    long long appendReceived_(Client& client, const Poller::Event& event);
+    int extractMessageLine_(RecvBuffer::Line& line, Client& client);
     void handleMalformedMessage_(Client& client, Message& message);
     char* port_;
     std::string password_;
@@ -55,15 +76,26 @@ class Server {
     int server_socket_protocol_ = DEFAULT_SOCKET_PROTOCOL;
     struct addrinfo hints_;
     struct addrinfo* srvinfo_;
-    std::map<int, Client> clients_;
-    std::map<std::string, Channel> channels_;
+    ClientTable clients_;
+    ChannelTable channels_;
     time_t start_time_;
+    Poller::Backend event_backend_;
+    int worker_count_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::mutex state_mutex_;  // guards clients_, channels_, the send queues and the pending writes of every reactor, see loopOnce_()
 
    public:
     ~Server();
     Server(char* port, std::string password);
     int start();
     void loop();
+    void loopOnce(int timeoutMs);
+    void stop();
+    void setEventBackend(Poller::Backend backend);
+    Poller::Backend getEventBackend();
+    int setWorkerCount(int workerCount);
+    int getWorkerCount() const;
+    unsigned long getClientCount();
     char* getPort();
     std::string getPassword();
     int getServerSocketFd();
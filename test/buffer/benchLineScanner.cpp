@@ -0,0 +1,85 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "../../src/buffer/LineScanner.h"
+#include "../../src/buffer/RecvBuffer.h"
+
+using namespace irc;
+
+// The previous checks: memchr for the line feed while framing, then memchr for a NUL in Message::checkNulChar
+static unsigned long frameWithTwoPasses(const std::string& text) {
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
+    unsigned long rejected = 0;
+    while (cursor < end) {
+        const char* lineFeed = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<unsigned long>(end - cursor)));
+        unsigned long length = static_cast<unsigned long>(lineFeed - cursor);
+        rejected += (std::memchr(cursor, '\0', length) != NULL || length > MAX_MSG_LENGTH) ? 1 : 0;
+        cursor = lineFeed + 1;
+    }
+    return rejected;
+}
+
+static unsigned long frameWithScanner(const std::string& text, LineScanner::Implementation implementation) {
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
+    unsigned long rejected = 0;
+    while (cursor < end) {
+        LineScanner::Result result = LineScanner::scan(cursor, static_cast<unsigned long>(end - cursor), implementation);
+        rejected += (result.containsNul || result.lineFeed > MAX_MSG_LENGTH) ? 1 : 0;
+        cursor += result.lineFeed + 1;
+    }
+    return rejected;
+}
+
+// Best of several runs, in bytes per nanosecond which is GB/s
+template <typename Function>
+static double gigabytesPerSecond(Function function, unsigned long bytes) {
+    double best = 0;
+    for (int run = 0; run < 20; run++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        best = std::max(best, static_cast<double>(bytes) / ns);
+    }
+    return best;
+}
+
+TEST_CASE("Line scanning throughput", "[.][benchmark][buffer]") {
+    const std::string lines[] = {
+        "PRIVMSG #channel :a line pasted by a client into the channel\r\n",
+        "PING :irc.example.com\r\n",
+        "PRIVMSG #channel :" + std::string(400, 'y') + "\r\n",
+    };
+    for (const std::string& line : lines) {
+        std::string text;
+        while (text.size() < 4 * 1024 * 1024) {
+            text += line;
+        }
+        unsigned long volatile sink = 0;
+        std::cout << line.size() << " byte lines: two memchr passes "
+                  << gigabytesPerSecond([&]() { sink = sink + frameWithTwoPasses(text); }, text.size()) << " GB/s";
+        for (LineScanner::Implementation implementation : {LineScanner::SCAN_SCALAR, LineScanner::SCAN_SSE2, LineScanner::SCAN_AVX2}) {
+            if (LineScanner::isSupported(implementation)) {
+                std::cout << ", " << LineScanner::getImplementationName(implementation) << " "
+                          << gigabytesPerSecond([&]() { sink = sink + frameWithScanner(text, implementation); }, text.size()) << " GB/s";
+            }
+        }
+        RecvBuffer recvBuffer;
+        double framing = gigabytesPerSecond(
+            [&]() {
+                recvBuffer.append(text);
+                RecvBuffer::Line frame;
+                while (recvBuffer.nextLine(frame)) {
+                    sink = sink + (frame.containsNul ? 1 : 0);
+                }
+            },
+            text.size());
+        std::cout << ", RecvBuffer::nextLine " << framing << " GB/s" << std::endl;
+        REQUIRE(sink == 0);
+    }
+}
@@ -0,0 +1,172 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <fcntl.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "../../src/buffer/RecvBuffer.h"
+
+using namespace irc;
+
+static const unsigned long burstSize = 128 * 1024;
+
+static void sendBurst(int fd, const std::string& burst) {
+    REQUIRE(send(fd, burst.data(), burst.size(), 0) == static_cast<long>(burst.size()));
+}
+
+// The previous receive path: one poll() wakeup, one memset and one 1 KiB recv() per event, then a copy
+static long receiveOnePerWakeup(int fd, std::string& recvBuffer) {
+    long syscalls = 0;
+    unsigned long received = 0;
+    pollfd readable = {fd, POLLIN, 0};
+    while (received < burstSize) {
+        char tmpRecvBuffer[1024];
+        poll(&readable, 1, -1);
+        memset(tmpRecvBuffer, 0, sizeof tmpRecvBuffer);
+        long recv_ret = recv(fd, tmpRecvBuffer, sizeof tmpRecvBuffer, 0);
+        syscalls += 2;
+        received += static_cast<unsigned long>(recv_ret);
+        recvBuffer.append(tmpRecvBuffer, static_cast<unsigned long>(recv_ret));
+    }
+    recvBuffer.clear();
+    return syscalls;
+}
+
+// The drain loop of Server::recvToBuffer_: one wakeup, recv() straight into the client buffer until EAGAIN
+static long receiveUntilEagain(int fd, RecvBuffer& recvBuffer) {
+    long syscalls = 0;
+    unsigned long received = 0;
+    pollfd readable = {fd, POLLIN, 0};
+    while (received < burstSize) {
+        poll(&readable, 1, -1);
+        syscalls++;
+        long total = 0;
+        while (total < SERVER_RECV_BUDGET_PER_EVENT) {
+            char* destination = recvBuffer.prepare(SERVER_RECV_BUFFER_SIZE);
+            long recv_ret = recv(fd, destination, recvBuffer.getWritableSize(), 0);
+            syscalls++;
+            if (recv_ret <= 0) {
+                break;
+            }
+            recvBuffer.commit(static_cast<unsigned long>(recv_ret));
+            total += recv_ret;
+        }
+        received += static_cast<unsigned long>(total);
+    }
+    recvBuffer.clear();
+    return syscalls;
+}
+
+TEST_CASE("Receive path syscalls and time per burst", "[.][benchmark][buffer]") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    int bufferSize = static_cast<int>(burstSize * 2);
+    setsockopt(fds[0], SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof bufferSize);
+    setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof bufferSize);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    std::string burst;
+    while (burst.size() < burstSize) {
+        burst += "PRIVMSG #channel :a line pasted by a client into the channel\r\n";
+    }
+    burst.resize(burstSize);
+    std::string stringBuffer;
+    RecvBuffer recvBuffer;
+
+    sendBurst(fds[1], burst);
+    long oneSyscalls = receiveOnePerWakeup(fds[0], stringBuffer);
+    sendBurst(fds[1], burst);
+    long drainSyscalls = receiveUntilEagain(fds[0], recvBuffer);
+    std::cout << "syscalls per KiB, 1 KiB recv per wakeup: " << static_cast<double>(oneSyscalls) / (burstSize / 1024) << std::endl
+              << "syscalls per KiB, recv until EAGAIN:     " << static_cast<double>(drainSyscalls) / (burstSize / 1024) << std::endl;
+    REQUIRE(drainSyscalls < oneSyscalls);
+
+    BENCHMARK("1 KiB recv per wakeup") {
+        sendBurst(fds[1], burst);
+        return receiveOnePerWakeup(fds[0], stringBuffer);
+    };
+
+    BENCHMARK("recv until EAGAIN") {
+        sendBurst(fds[1], burst);
+        return receiveUntilEagain(fds[0], recvBuffer);
+    };
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// The previous framing: search from the start of a std::string, then erase the line from its front
+static unsigned long frameWithErase(const std::string& packet) {
+    std::string recvBuffer = packet;
+    unsigned long lines = 0;
+    unsigned long pos;
+    while ((pos = recvBuffer.find("\r\n")) != std::string::npos) {
+        std::string message = recvBuffer.substr(0, pos);
+        recvBuffer.erase(0, pos + 2);
+        lines += message.size() > 0 ? 1 : 0;
+    }
+    return lines;
+}
+
+static unsigned long frameWithNextLine(RecvBuffer& recvBuffer, const std::string& packet) {
+    recvBuffer.append(packet);
+    unsigned long lines = 0;
+    RecvBuffer::Line line;
+    while (recvBuffer.nextLine(line)) {
+        lines += line.length > 0 ? 1 : 0;
+    }
+    return lines;
+}
+
+// Feeds one long line in small packets and tries to frame it after each one, like a slow client would
+static unsigned long trickleLine(RecvBuffer& recvBuffer, unsigned long length, unsigned long packetSize) {
+    std::string packet(packetSize, 'x');
+    unsigned long attempts = 0;
+    RecvBuffer::Line line;
+    for (unsigned long sent = 0; sent < length; sent += packetSize) {
+        recvBuffer.append(packet);
+        attempts += recvBuffer.nextLine(line) ? 0 : 1;
+    }
+    recvBuffer.append("\r\n");
+    REQUIRE(recvBuffer.nextLine(line) == true);
+    return attempts;
+}
+
+template <typename Function>
+static double nanosecondsPerCall(Function function, unsigned long calls) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / static_cast<double>(calls);
+}
+
+TEST_CASE("Framing cost per message with many messages per packet", "[.][benchmark][buffer]") {
+    const unsigned long counts[] = {100, 1000, 10000, 50000};
+    const std::string message = "PRIVMSG #channel :a line pasted by a client into the channel\r\n";
+    RecvBuffer recvBuffer;
+
+    for (unsigned long count : counts) {
+        std::string packet;
+        for (unsigned long i = 0; i < count; i++) {
+            packet += message;
+        }
+        unsigned long eraseLines = 0;
+        unsigned long nextLineLines = 0;
+        double eraseNs = nanosecondsPerCall([&]() { eraseLines = frameWithErase(packet); }, count);
+        double nextLineNs = nanosecondsPerCall([&]() { nextLineLines = frameWithNextLine(recvBuffer, packet); }, count);
+        REQUIRE(eraseLines == count);
+        REQUIRE(nextLineLines == count);
+        std::cout << count << " messages in one packet: find + erase " << eraseNs << " ns/message, nextLine " << nextLineNs
+                  << " ns/message" << std::endl;
+    }
+
+    const unsigned long lengths[] = {1024, 16384, 131072};
+    for (unsigned long length : lengths) {
+        double ns = nanosecondsPerCall([&]() { trickleLine(recvBuffer, length, 16); }, length);
+        std::cout << length << " byte line in 16 byte packets: nextLine " << ns << " ns/byte" << std::endl;
+    }
+}
@@ -0,0 +1,85 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/uio.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../src/buffer/SendQueue.h"
+
+using namespace irc;
+
+static const std::string line = ":nick!user@127.0.0.1 PRIVMSG #channel :a line for a client that reads slowly\r\n";
+
+/**
+ * Drains a backlog the way a slow reader forces the server to: the socket only accepts
+ * writeSize bytes per writable event. Returns the elapsed time in milliseconds.
+ */
+static double drainStringBacklog(unsigned long backlog, unsigned long writeSize) {
+    std::string buffer;
+    while (buffer.size() < backlog) {
+        buffer += line;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (buffer.empty() == false) {
+        // send(fd, buffer.c_str(), buffer.size()) accepted writeSize bytes
+        buffer.erase(0, writeSize < buffer.size() ? writeSize : buffer.size());
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double drainQueueBacklog(unsigned long backlog, unsigned long writeSize) {
+    SendQueue queue;
+    while (queue.size() < backlog) {
+        queue.append(line);
+    }
+    struct iovec iovecs[SEND_QUEUE_MAX_IOVECS];
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (queue.empty() == false) {
+        // sendmsg(fd, iovecs) accepted writeSize bytes
+        queue.gather(iovecs, SEND_QUEUE_MAX_IOVECS);
+        queue.consume(writeSize);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST_CASE("Draining a slow reader's backlog with partial writes", "[.][benchmark][buffer]") {
+    const unsigned long backlogs[] = {256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024};
+    const unsigned long writeSize = 16 * 1024;
+
+    for (unsigned long backlog : backlogs) {
+        double stringMs = drainStringBacklog(backlog, writeSize);
+        double queueMs = drainQueueBacklog(backlog, writeSize);
+        std::cout << backlog / 1024 << " KiB backlog in " << writeSize / 1024 << " KiB writes: std::string erase " << stringMs
+                  << " ms, chunked queue " << queueMs << " ms" << std::endl;
+    }
+}
+
+TEST_CASE("Channel fanout with copied vs shared payloads", "[.][benchmark][buffer]") {
+    const unsigned long members = 5000;
+    const std::string message = ":nick!user@127.0.0.1 PRIVMSG #channel :" + std::string(400, 'x') + "\r\n";
+    std::vector<SendQueue> queues(members);
+
+    BENCHMARK("copy the message into every member's queue") {
+        for (SendQueue& queue : queues) {
+            queue.append(message);
+        }
+        for (SendQueue& queue : queues) {
+            queue.clear();
+        }
+    };
+
+    BENCHMARK("share one payload between all member queues") {
+        SharedPayload payload = std::make_shared<const std::string>(message);
+        for (SendQueue& queue : queues) {
+            queue.append(payload);
+        }
+        for (SendQueue& queue : queues) {
+            queue.clear();
+        }
+    };
+
+    std::cout << members << " members, " << message.size() << " byte message: copied " << members * message.size()
+              << " bytes of payload, shared " << message.size() << " bytes of payload" << std::endl;
+}
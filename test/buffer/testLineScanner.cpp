@@ -0,0 +1,87 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <random>
+#include <string>
+#include "../../src/buffer/LineScanner.h"
+
+using namespace irc;
+
+static const LineScanner::Implementation implementations[] = {LineScanner::SCAN_SCALAR, LineScanner::SCAN_SSE2,
+                                                              LineScanner::SCAN_AVX2};
+
+TEST_CASE("LineScanner finds the first line feed and what precedes it", "[buffer]") {
+    for (LineScanner::Implementation implementation : implementations) {
+        if (LineScanner::isSupported(implementation) == false) {
+            continue;
+        }
+        INFO(LineScanner::getImplementationName(implementation));
+        std::string text(100, 'a');
+
+        LineScanner::Result result = LineScanner::scan(text.data(), text.size(), implementation);
+        REQUIRE(result.lineFeed == 100);
+        REQUIRE(result.containsNul == false);
+        REQUIRE(result.containsNonAscii == false);
+
+        // the flags only look at the bytes before the line feed, on every side of a 16 and 32 byte block
+        for (unsigned long position : {0ul, 1ul, 15ul, 16ul, 31ul, 32ul, 33ul, 70ul, 99ul}) {
+            std::string line = text;
+            line[99 - position / 2] = '\0';
+            line[position / 2] = '\xE9';
+            line[position] = '\n';
+            result = LineScanner::scan(line.data(), line.size(), implementation);
+            REQUIRE(result.lineFeed == position);
+            REQUIRE(result.containsNul == (99 - position / 2 < position));
+            REQUIRE(result.containsNonAscii == (position / 2 < position));
+        }
+    }
+}
+
+TEST_CASE("LineScanner implementations agree on random bytes", "[buffer]") {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> lengths(0, 200);
+    std::uniform_int_distribution<int> bytes(0, 255);
+    std::uniform_int_distribution<int> rare(0, 40);
+    for (int round = 0; round < 2000; round++) {
+        std::string text(static_cast<unsigned long>(lengths(random)), 'x');
+        for (char& c : text) {
+            int kind = rare(random);  // mostly ASCII text, now and then one of the interesting bytes
+            c = (kind == 0) ? '\n' : (kind == 1) ? '\0' : (kind == 2) ? static_cast<char>(bytes(random)) : 'x';
+        }
+        unsigned long offset = static_cast<unsigned long>(round % 7);  // unaligned starts too
+        if (offset > text.size()) {
+            offset = 0;
+        }
+        LineScanner::Result expected = LineScanner::scan(text.data() + offset, text.size() - offset, LineScanner::SCAN_SCALAR);
+        for (LineScanner::Implementation implementation : implementations) {
+            if (LineScanner::isSupported(implementation) == false) {
+                continue;
+            }
+            LineScanner::Result result = LineScanner::scan(text.data() + offset, text.size() - offset, implementation);
+            REQUIRE(result.lineFeed == expected.lineFeed);
+            REQUIRE(result.containsNul == expected.containsNul);
+            REQUIRE(result.containsNonAscii == expected.containsNonAscii);
+        }
+    }
+}
+
+TEST_CASE("LineScanner validates UTF-8", "[buffer]") {
+    const char* valid[] = {"", "plain ascii", "caf\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xED\x9F\xBF", "\xF4\x8F\xBF\xBF"};
+    const char* invalid[] = {
+        "\xC3",              // truncated
+        "\xC0\xAF",          // overlong
+        "\xE0\x80\xAF",      // overlong
+        "\xED\xA0\x80",      // surrogate
+        "\xF4\x90\x80\x80",  // above U+10FFFF
+        "\xF5\x80\x80\x80",  // invalid lead byte
+        "\x80",              // lone continuation byte
+        "caf\xE9",           // latin-1
+    };
+    for (const char* text : valid) {
+        INFO(text);
+        REQUIRE(LineScanner::isValidUtf8(text, std::string(text).size()) == true);
+    }
+    for (const char* text : invalid) {
+        INFO(text);
+        REQUIRE(LineScanner::isValidUtf8(text, std::string(text).size()) == false);
+    }
+}
@@ -0,0 +1,215 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include "../../src/buffer/RecvBuffer.h"
+
+using namespace irc;
+
+static void receiveInto(RecvBuffer& buffer, const std::string& packet) {
+    char* destination = buffer.prepare(packet.size());
+    REQUIRE(buffer.getWritableSize() >= packet.size());
+    std::memcpy(destination, packet.data(), packet.size());
+    buffer.commit(packet.size());
+}
+
+TEST_CASE("RecvBuffer", "[buffer]") {
+    int errno_before = errno;
+    RecvBuffer buffer;
+    REQUIRE(buffer.empty());
+    REQUIRE(buffer.size() == 0);
+    REQUIRE(buffer.toString() == "");
+
+    SECTION("received data is readable until consumed") {
+        receiveInto(buffer, "NICK tester\r\nUSER");
+        REQUIRE(buffer.toString() == "NICK tester\r\nUSER");
+        buffer.consume(13);
+        REQUIRE(buffer.toString() == "USER");
+        receiveInto(buffer, " tester\r\n");
+        REQUIRE(buffer.toString() == "USER tester\r\n");
+        buffer.consume(13);
+        REQUIRE(buffer.empty());
+    }
+
+    SECTION("consumed space is reused before the buffer grows") {
+        std::string packet(RECV_BUFFER_INITIAL_CAPACITY - 2, 'a');
+        receiveInto(buffer, packet);
+        const char* firstBlock = buffer.data();
+        buffer.consume(packet.size() - 2);
+        receiveInto(buffer, "bcdef");
+        REQUIRE(buffer.data() == firstBlock);
+        REQUIRE(buffer.toString() == "aabcdef");
+    }
+
+    SECTION("the buffer grows for bursts bigger than its capacity") {
+        std::string burst(RECV_BUFFER_INITIAL_CAPACITY * 3 + 7, 'x');
+        buffer.append("PING");
+        buffer.append(burst);
+        REQUIRE(buffer.size() == burst.size() + 4);
+        REQUIRE(buffer.toString() == "PING" + burst);
+    }
+
+    SECTION("copies are independent") {
+        buffer.append("PRIVMSG #test :hello");
+        RecvBuffer copy(buffer);
+        buffer.consume(8);
+        REQUIRE(copy.toString() == "PRIVMSG #test :hello");
+        REQUIRE(buffer.toString() == "#test :hello");
+        copy = buffer;
+        REQUIRE(copy.toString() == "#test :hello");
+    }
+
+    SECTION("consuming more than the size empties the buffer") {
+        buffer.append("PING");
+        buffer.consume(100);
+        REQUIRE(buffer.empty());
+    }
+    REQUIRE(errno == errno_before);
+}
+
+static std::string lineToString(const RecvBuffer::Line& line) {
+    return std::string(line.data, line.length);
+}
+
+TEST_CASE("RecvBuffer frames CRLF terminated lines", "[buffer]") {
+    int errno_before = errno;
+    RecvBuffer buffer;
+    RecvBuffer::Line line;
+
+    SECTION("several lines in one packet are returned in order") {
+        buffer.append("NICK alice\r\nUSER a 0 * :A\r\nPING");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "NICK alice");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "USER a 0 * :A");
+        REQUIRE(buffer.nextLine(line) == false);
+        REQUIRE(buffer.toString() == "PING");
+    }
+
+    SECTION("the line points into the buffer instead of a copy") {
+        buffer.append("PING a\r\nPING b\r\n");
+        const char* start = buffer.data();
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.data == start);
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.data == start + 8);
+        REQUIRE(buffer.empty());
+    }
+
+    SECTION("a line split over several packets, including inside the CRLF") {
+        buffer.append("PRIV");
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.append("MSG #x :hi\r");
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.append("\nPI");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PRIVMSG #x :hi");
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.append("NG\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PING");
+    }
+
+    SECTION("a lone line feed does not end a line") {
+        buffer.append("PING a\nb\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PING a\nb");
+    }
+
+    SECTION("empty lines are returned as empty") {
+        buffer.append("\r\nPING\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.length == 0);
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PING");
+    }
+
+    SECTION("consume and clear forget the scanned part") {
+        buffer.append("PING abc");
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.consume(5);
+        buffer.append("\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "abc");
+        buffer.append("PING");
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.clear();
+        buffer.append("\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.length == 0);
+    }
+
+    SECTION("NUL and non-ASCII bytes are flagged per line, also when the line arrives in parts") {
+        buffer.append("PRIVMSG #x :caf\xC3\xA9\r\nPING");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.containsNul == false);
+        REQUIRE(line.containsNonAscii == true);
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.append(std::string(" a\0b", 4));
+        REQUIRE(buffer.nextLine(line) == false);
+        buffer.append(" c\nd\r\nPING\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.length == 12);
+        REQUIRE(line.containsNul == true);
+        REQUIRE(line.containsNonAscii == false);
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.containsNul == false);
+        REQUIRE(line.containsNonAscii == false);
+    }
+    REQUIRE(errno == errno_before);
+}
+
+TEST_CASE("RecvBuffer drops the rest of lines longer than MAX_MSG_LENGTH", "[buffer]") {
+    RecvBuffer buffer;
+    RecvBuffer::Line line;
+
+    SECTION("a line of MAX_MSG_LENGTH bytes is not too long") {
+        buffer.append(std::string(MAX_MSG_LENGTH, 'a') + "\r\nPING\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.length == MAX_MSG_LENGTH);
+        REQUIRE(line.isTooLong == false);
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PING");
+    }
+
+    SECTION("a client that never sends a line feed keeps the buffer bounded") {
+        buffer.append("PRIVMSG #x :" + std::string(600, 'a'));
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.isTooLong == true);
+        REQUIRE(line.length == MAX_MSG_LENGTH);
+        REQUIRE(lineToString(line).compare(0, 12, "PRIVMSG #x :") == 0);
+        REQUIRE(buffer.nextLine(line) == false);
+        REQUIRE(buffer.empty());
+        for (int packet = 0; packet < 1000; packet++) {
+            buffer.append(std::string(4096, 'a'));
+            REQUIRE(buffer.nextLine(line) == false);
+            REQUIRE(buffer.size() <= MAX_MSG_LENGTH + 2);
+        }
+        buffer.append("\nstill the same line\r");
+        REQUIRE(buffer.nextLine(line) == false);
+        REQUIRE(buffer.size() == 1);
+        buffer.append("\nPING\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.isTooLong == false);
+        REQUIRE(lineToString(line) == "PING");
+        REQUIRE(buffer.empty());
+    }
+
+    SECTION("the CRLF can follow the searched bytes directly") {
+        buffer.append(std::string(MAX_MSG_LENGTH + 1, 'a') + "\r\nPING\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(line.isTooLong == true);
+        REQUIRE(buffer.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PING");
+    }
+
+    SECTION("copies are still skipping the line") {
+        buffer.append(std::string(MAX_MSG_LENGTH + 10, 'a'));
+        REQUIRE(buffer.nextLine(line) == true);
+        RecvBuffer copy(buffer);
+        copy.append("a\r\nPING\r\n");
+        REQUIRE(copy.nextLine(line) == true);
+        REQUIRE(lineToString(line) == "PING");
+    }
+}
@@ -0,0 +1,192 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include "../../src/buffer/SendQueue.h"
+#include "../../src/common/reply.h"
+#include "../common/allocationCount.h"
+
+using namespace irc;
+
+TEST_CASE("SendQueue keeps queued data in chunks", "[buffer]") {
+    int errno_before = errno;
+    SendQueue queue;
+    struct iovec iovecs[SEND_QUEUE_MAX_IOVECS];
+
+    REQUIRE(queue.empty());
+    REQUIRE(queue.gather(iovecs, SEND_QUEUE_MAX_IOVECS) == 0);
+
+    SECTION("small messages are coalesced into one chunk") {
+        queue.append(":irc PONG irc\r\n");
+        queue.append(":irc PONG irc\r\n");
+        REQUIRE(queue.getChunkCount() == 1);
+        REQUIRE(queue.size() == 30);
+        REQUIRE(queue.toString() == ":irc PONG irc\r\n:irc PONG irc\r\n");
+    }
+
+    SECTION("replies are written into the last chunk like copied messages") {
+        const std::string nickname = "xuffy";
+        queue.append(":irc PONG irc\r\n");
+        queue.append(RPL_ERR_NOSUCHNICK_401(std::string("irc"), nickname));
+        REQUIRE(queue.getChunkCount() == 1);
+        REQUIRE(queue.toString() == ":irc PONG irc\r\n" + RPL_ERR_NOSUCHNICK_401(std::string("irc"), nickname).toString());
+        REQUIRE(queue.size() == queue.toString().size());
+
+        queue.consume(queue.size());
+        std::string big(SEND_QUEUE_CHUNK_SIZE, 'b');
+        queue.append(REPLY_LINE(big));
+        queue.append(RPL_MESSAGE("PING"));
+        REQUIRE(queue.getChunkCount() == 2);
+        REQUIRE(queue.toString() == big + "PING\r\n");
+
+        long before = allocationCount_g;
+        queue.append(RPL_MESSAGE("PING"));
+        REQUIRE(allocationCount_g - before == 0);
+    }
+
+    SECTION("a chunk is not grown past SEND_QUEUE_CHUNK_SIZE") {
+        std::string message(SEND_QUEUE_CHUNK_SIZE / 2 + 1, 'a');
+        queue.append(message);
+        queue.append(message);
+        REQUIRE(queue.getChunkCount() == 2);
+        std::string big(SEND_QUEUE_CHUNK_SIZE * 3, 'b');
+        queue.append(big);
+        REQUIRE(queue.getChunkCount() == 3);
+        REQUIRE(queue.size() == message.size() * 2 + big.size());
+        REQUIRE(queue.gather(iovecs, SEND_QUEUE_MAX_IOVECS) == 3);
+        REQUIRE(iovecs[2].iov_len == big.size());
+        REQUIRE(queue.gather(iovecs, 2) == 2);
+    }
+
+    SECTION("a partial write advances the offset into the first chunk") {
+        std::string first(SEND_QUEUE_CHUNK_SIZE, '1');
+        std::string second(SEND_QUEUE_CHUNK_SIZE, '2');
+        queue.append(first);
+        queue.append(second);
+        queue.consume(10);
+        REQUIRE(queue.getChunkCount() == 2);
+        REQUIRE(queue.gather(iovecs, SEND_QUEUE_MAX_IOVECS) == 2);
+        REQUIRE(iovecs[0].iov_len == first.size() - 10);
+        REQUIRE(static_cast<char*>(iovecs[0].iov_base)[0] == '1');
+
+        queue.consume(first.size() - 10 + 5);
+        REQUIRE(queue.getChunkCount() == 1);
+        REQUIRE(queue.size() == second.size() - 5);
+        REQUIRE(queue.toString() == second.substr(5));
+
+        queue.consume(second.size());
+        REQUIRE(queue.empty());
+        REQUIRE(queue.getChunkCount() == 0);
+    }
+
+    SECTION("data appended after a partial write keeps its order") {
+        queue.append("PING a\r\n");
+        queue.consume(3);
+        queue.append("PING b\r\n");
+        REQUIRE(queue.toString() == "G a\r\nPING b\r\n");
+    }
+
+    SECTION("the gathered chunks can be written with writev") {
+        int fds[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        std::string big(SEND_QUEUE_CHUNK_SIZE + 100, 'x');
+        queue.append("hello ");
+        queue.append(big);
+        queue.append("world");
+        long written = writev(fds[0], iovecs, queue.gather(iovecs, SEND_QUEUE_MAX_IOVECS));
+        REQUIRE(written == static_cast<long>(queue.size()));
+        queue.consume(static_cast<unsigned long>(written));
+        REQUIRE(queue.empty());
+
+        std::string received(big.size() + 11, '\0');
+        REQUIRE(read(fds[1], &received[0], received.size()) == static_cast<long>(received.size()));
+        REQUIRE(received == "hello " + big + "world");
+        close(fds[0]);
+        close(fds[1]);
+    }
+    REQUIRE(errno == errno_before);
+}
+
+TEST_CASE("SendQueue shares broadcast payloads instead of copying them", "[buffer]") {
+    int errno_before = errno;
+    SharedPayload payload = std::make_shared<const std::string>(":a!a@host PRIVMSG #x :hi\r\n");
+    SendQueue first;
+    SendQueue second;
+    struct iovec iovecs[SEND_QUEUE_MAX_IOVECS];
+
+    first.append(payload);
+    second.append("PING\r\n");
+    second.append(payload);
+    REQUIRE(payload.use_count() == 3);
+    REQUIRE(first.gather(iovecs, SEND_QUEUE_MAX_IOVECS) == 1);
+    REQUIRE(iovecs[0].iov_base == payload->data());
+
+    SECTION("owned data is not coalesced into a shared chunk") {
+        first.append("PONG\r\n");
+        REQUIRE(first.getChunkCount() == 2);
+        REQUIRE(*payload == ":a!a@host PRIVMSG #x :hi\r\n");
+        REQUIRE(first.toString() == *payload + "PONG\r\n");
+    }
+
+    SECTION("partial writes of a shared chunk do not affect other queues") {
+        first.consume(5);
+        REQUIRE(first.gather(iovecs, SEND_QUEUE_MAX_IOVECS) == 1);
+        REQUIRE(iovecs[0].iov_base == payload->data() + 5);
+        REQUIRE(second.toString() == "PING\r\n" + *payload);
+        first.consume(first.size());
+        REQUIRE(payload.use_count() == 2);
+    }
+
+    SECTION("the payload is released once every queue sent it") {
+        first.clear();
+        second.consume(second.size());
+        REQUIRE(payload.use_count() == 1);
+    }
+    REQUIRE(errno == errno_before);
+}
+
+TEST_CASE("SendQueue puts back unsent data in front of data queued meanwhile", "[buffer]") {
+    SharedPayload payload = std::make_shared<const std::string>(":a!a@host PRIVMSG #x :hi\r\n");
+    SendQueue live;
+    SendQueue sending;
+    live.append("PING\r\n");
+    live.append(payload);
+    sending.swap(live);
+    REQUIRE(live.empty());
+    REQUIRE(sending.toString() == "PING\r\n" + *payload);
+
+    SECTION("a partial write keeps its offset") {
+        sending.consume(5);
+        live.append("PONG\r\n");
+        live.prepend(sending);
+        REQUIRE(sending.empty());
+        REQUIRE(live.toString() == "\n" + *payload + "PONG\r\n");
+        REQUIRE(live.size() == live.toString().size());
+    }
+
+    SECTION("nothing queued meanwhile") {
+        sending.consume(6);
+        live.prepend(sending);
+        REQUIRE(live.toString() == *payload);
+        REQUIRE(payload.use_count() == 2);
+    }
+
+    SECTION("everything was sent") {
+        sending.consume(sending.size());
+        live.append(payload);
+        live.prepend(sending);
+        REQUIRE(live.toString() == *payload);
+    }
+
+    SECTION("data queued meanwhile that was partially sent loses its sent part") {
+        live.append(payload);
+        live.consume(3);
+        live.prepend(sending);
+        REQUIRE(live.toString() == "PING\r\n" + *payload + payload->substr(3));
+        REQUIRE(payload.use_count() == 2);
+    }
+}
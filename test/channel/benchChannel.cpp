@@ -0,0 +1,314 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/socket.h>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../src/channel/ChannelTable.h"
+
+using namespace irc;
+
+// The previous membership: one vector per role, every check a scan comparing fds
+struct VectorMembership {
+    std::vector<Client*> members;
+    std::vector<Client*> operators;
+
+    static bool contains(const std::vector<Client*>& clients, const Client& client) {
+        for (Client* candidate : clients) {
+            if (candidate->getFd() == client.getFd()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string getNamesList() const {
+        std::string namesList;
+        for (Client* member : members) {
+            if (contains(operators, *member)) {
+                namesList.append(CHANNEL_OPERATOR_SYMBOL);
+            }
+            namesList.append(member->getNickname() + " ");
+        }
+        namesList.pop_back();
+        return namesList;
+    }
+};
+
+TEST_CASE("Channel membership at 10k members", "[.][benchmark][channel]") {
+    const int memberCount = 10000;
+    struct sockaddr sockaddr {};
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int fd = 5; fd < 5 + memberCount; fd++) {
+        clients.emplace_back(new Client(fd, sockaddr));
+        clients.back()->setNickname("u" + std::to_string(fd - 5));
+    }
+
+    ChannelTable channels;
+    Channel& channel = *channels.insert(*clients[0], "#big");
+    VectorMembership previous;
+    previous.members.push_back(clients[0].get());
+    previous.operators.push_back(clients[0].get());
+    for (int index = 1; index < memberCount; index++) {
+        channel.joinMember(*clients[index]);
+        previous.members.push_back(clients[index].get());
+        // Every hundredth member is an operator
+        if (index % 100 == 0) {
+            channel.setOperatorStatus(*clients[index], true);
+            previous.operators.push_back(clients[index].get());
+        }
+    }
+    REQUIRE(channel.getMemberCount() == memberCount);
+    REQUIRE(channel.getNamesList() == previous.getNamesList());
+
+    // The members that joined last are the worst case of a scan
+    std::vector<Client*> probes;
+    for (int index = memberCount - 20; index < memberCount; index++) {
+        probes.push_back(clients[index].get());
+    }
+
+    BENCHMARK("NAMES, vectors scanned per member") {
+        return previous.getNamesList().size();
+    };
+
+    BENCHMARK("NAMES, membership flags") {
+        return channel.getNamesList().size();
+    };
+
+    BENCHMARK("20 isMember + isOperator, vectors") {
+        long found = 0;
+        for (Client* probe : probes) {
+            found += VectorMembership::contains(previous.members, *probe) + VectorMembership::contains(previous.operators, *probe);
+        }
+        return found;
+    };
+
+    BENCHMARK("20 isMember + isOperator, membership flags") {
+        long found = 0;
+        for (Client* probe : probes) {
+            found += channel.isMember(*probe) + channel.isOperator(*probe);
+        }
+        return found;
+    };
+    std::cout << "names list of " << memberCount << " members: " << channel.getNamesList().size() << " bytes" << std::endl;
+}
+
+TEST_CASE("JOIN of a 10k-member channel", "[.][benchmark][channel]") {
+    const int memberCount = 10000;
+    struct sockaddr sockaddr {};
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int fd = 5; fd < 5 + memberCount; fd++) {
+        clients.emplace_back(new Client(fd, sockaddr));
+        clients.back()->setNickname("u" + std::to_string(fd - 5));
+    }
+    ChannelTable channels;
+    Channel& channel = *channels.insert(*clients[0], "#big");
+    for (int index = 1; index < memberCount; index++) {
+        channel.joinMember(*clients[index]);
+        if (index % 100 == 0) {
+            channel.setOperatorStatus(*clients[index], true);
+        }
+    }
+    Client joiner(5 + memberCount, sockaddr);
+    joiner.setNickname("joiner");
+
+    // The previous JOIN: the names of every member rendered again into one RPL_NAMREPLY_353 of any length
+    auto previousJoin = [&]() {
+        channel.joinMember(joiner);
+        std::string namesList;
+        for (Client* member : channel.getMembers()) {
+            if (channel.isOperator(*member)) {
+                namesList.append(CHANNEL_OPERATOR_SYMBOL);
+            }
+            namesList.append(member->getNickname() + " ");
+        }
+        namesList.pop_back();
+        joiner.appendToSendBuffer(RPL_NAMREPLY_353(serverHostname_g, joiner.getNickname(), CHANNEL_SYMBOL_PUBLIC, channel.getName(), namesList));
+        channel.partMember(joiner);
+    };
+    // The current JOIN: the kept lines, one RPL_NAMREPLY_353 each, and RPL_ENDOFNAMES
+    auto currentJoin = [&]() {
+        channel.joinMember(joiner);
+        for (const std::string& namesLine : channel.getNamesLines()) {
+            if (namesLine.empty() == false) {
+                joiner.appendToSendBuffer(
+                    RPL_NAMREPLY_353(serverHostname_g, joiner.getNickname(), CHANNEL_SYMBOL_PUBLIC, channel.getName(), namesLine));
+            }
+        }
+        joiner.appendToSendBuffer(RPL_ENDOFNAMES_366(serverHostname_g, joiner.getNickname(), channel.getName()));
+        channel.partMember(joiner);
+    };
+    previousJoin();
+    unsigned long previousBytes = joiner.getSendBuffer().size();
+    joiner.clearSendBuffer();
+    currentJoin();
+    std::string reply = joiner.getSendBuffer();
+    joiner.clearSendBuffer();
+    unsigned long lineCount = 0;
+    for (unsigned long start = 0; start < reply.size(); lineCount++) {
+        unsigned long end = reply.find("\r\n", start) + 2;
+        REQUIRE(end - start <= MAX_MSG_LENGTH);
+        start = end;
+    }
+
+    BENCHMARK("join, names rendered into one line, part") {
+        previousJoin();
+        joiner.clearSendBuffer();
+    };
+
+    BENCHMARK("join, kept names lines, part") {
+        currentJoin();
+        joiner.clearSendBuffer();
+    };
+
+    // What the membership changes themselves cost now that they keep the names lines up to date
+    BENCHMARK("join + part alone") {
+        channel.joinMember(joiner);
+        channel.partMember(joiner);
+    };
+    std::cout << "names reply to a JOIN of " << memberCount << " members: one line of " << previousBytes << " bytes before, "
+              << lineCount << " lines of at most " << MAX_MSG_LENGTH << " bytes (" << reply.size() << " bytes) now" << std::endl;
+}
+
+TEST_CASE("Channel name resolution at 100k channels", "[.][benchmark][channel]") {
+    const int channelCount = 100000;
+    struct sockaddr sockaddr {};
+    Client creator(5, sockaddr);
+    creator.setNickname("creator");
+    ChannelTable channels;
+    // The previous channel map, the value standing in for the Channel and its name
+    std::map<std::string, std::string> previous;
+    for (int index = 0; index < channelCount; index++) {
+        std::string name = "#channel" + std::to_string(index);
+        REQUIRE(channels.insert(creator, name) != nullptr);
+        previous[name] = name;
+    }
+
+    // Half of the JOINs go to existing channels, half create one
+    std::vector<std::string> names;
+    for (int index = 0; index < 20; index++) {
+        names.push_back("#channel" + std::to_string(index * 4999) + (index % 2 == 0 ? "" : "new"));
+    }
+
+    BENCHMARK("20 isChannelNameFree, scan of the whole map") {
+        long free = 0;
+        for (const std::string& name : names) {
+            bool isFree = true;
+            for (auto it = previous.begin(); it != previous.end(); it++) {
+                std::string channelName = it->second;  // Channel::getName() returned a copy
+                if (channelName == name) {
+                    isFree = false;
+                    break;
+                }
+            }
+            free += isFree;
+        }
+        return free;
+    };
+
+    BENCHMARK("20 std::map::find, case-sensitive") {
+        long free = 0;
+        for (const std::string& name : names) {
+            free += previous.find(name) == previous.end();
+        }
+        return free;
+    };
+
+    BENCHMARK("20 ChannelTable::getOrNull, casefolded") {
+        long free = 0;
+        for (const std::string& name : names) {
+            free += channels.getOrNull(name) == nullptr;
+        }
+        return free;
+    };
+}
+
+TEST_CASE("Iterating the channels of a client", "[.][benchmark][channel]") {
+    struct sockaddr sockaddr {};
+    Client client(5, sockaddr);
+    client.setNickname("client");
+    ChannelTable channels;
+    std::map<std::string, int> byName;  // the previous channel map, resolved per name
+    std::vector<std::string> names;     // the previous list of the client, copied by NICK, QUIT and JOIN 0
+    for (int index = 0; index < MAX_JOIN_CHANNELS; index++) {
+        std::string name = "#a-long-channel-name-" + std::to_string(index);
+        channels.insert(client, name);
+        byName[name] = index;
+        names.push_back(name);
+    }
+    REQUIRE(client.getMyChannels().size() == MAX_JOIN_CHANNELS);
+
+    BENCHMARK("copy the names, look each up") {
+        long sum = 0;
+        std::vector<std::string> copy = names;
+        for (const std::string& name : copy) {
+            sum += byName.at(name);
+        }
+        return sum;
+    };
+
+    BENCHMARK("channel handles") {
+        long sum = 0;
+        for (Channel* channel : client.getMyChannels()) {
+            sum += static_cast<long>(channel->getMemberCount());
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("QUIT fanout to peers sharing 15 channels", "[.][benchmark][channel]") {
+    const int channelCount = 15;
+    const int peerCount = 100;
+    struct sockaddr sockaddr {};
+    Client quitter(4, sockaddr);
+    quitter.setNickname("quitter");
+    std::vector<std::unique_ptr<Client>> peers;
+    ChannelTable channels;
+    for (int index = 0; index < channelCount; index++) {
+        channels.insert(quitter, "#shared" + std::to_string(index));
+    }
+    for (int fd = 5; fd < 5 + peerCount; fd++) {
+        peers.emplace_back(new Client(fd, sockaddr));
+        for (Channel* channel : quitter.getMyChannels()) {
+            channel->joinMember(*peers.back());
+        }
+    }
+    SharedPayload message = std::make_shared<const std::string>(":quitter!user@127.0.0.1 QUIT :Gone to have lunch\r\n");
+
+    auto queuedBytes = [&]() {
+        unsigned long bytes = 0;
+        for (const std::unique_ptr<Client>& peer : peers) {
+            bytes += peer->getSendBuffer().size();
+            peer->clearSendBuffer();
+        }
+        return bytes;
+    };
+    for (Channel* channel : quitter.getMyChannels()) {
+        channel->sendMessageToMembersExcluding(message, quitter);
+    }
+    unsigned long perChannelBytes = queuedBytes();
+    Channel::sendMessageToNeighbours(quitter, message);
+    unsigned long neighbourBytes = queuedBytes();
+    REQUIRE(neighbourBytes == peerCount * message->size());
+
+    // The previous fanout: the whole message queued to every member of every channel
+    BENCHMARK("once per channel") {
+        for (Channel* channel : quitter.getMyChannels()) {
+            channel->sendMessageToMembersExcluding(message, quitter);
+        }
+        for (const std::unique_ptr<Client>& peer : peers) {
+            peer->clearSendBuffer();
+        }
+    };
+
+    BENCHMARK("once per neighbour") {
+        Channel::sendMessageToNeighbours(quitter, message);
+        for (const std::unique_ptr<Client>& peer : peers) {
+            peer->clearSendBuffer();
+        }
+    };
+    std::cout << "bytes queued to " << peerCount << " peers: " << perChannelBytes << " once per channel, " << neighbourBytes
+              << " once per neighbour" << std::endl;
+}
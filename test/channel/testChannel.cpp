@@ -0,0 +1,245 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/socket.h>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../src/channel/ChannelTable.h"
+
+using namespace irc;
+
+TEST_CASE("Channel keeps membership, operator status and invitations per client", "[channel]") {
+    struct sockaddr sockaddr {};
+    ChannelTable channels;
+    Client alice(4, sockaddr);
+    Client bob(5, sockaddr);
+    Client carol(6, sockaddr);
+    alice.setNickname("alice");
+    bob.setNickname("bob");
+    carol.setNickname("carol");
+    Channel& channel = *channels.insert(alice, "#chan");
+
+    SECTION("the creator is the first member and operator") {
+        REQUIRE(channel.isMember(alice));
+        REQUIRE(channel.isOperator(alice));
+        REQUIRE_FALSE(channel.isMember(bob));
+        REQUIRE_FALSE(channel.isOperator(bob));
+        REQUIRE(channel.getMemberCount() == 1);
+        REQUIRE(channel.getNamesList() == "@alice");
+    }
+
+    SECTION("NAMES lists members in join order with operators marked") {
+        channel.joinMember(bob);
+        channel.joinMember(carol);
+        channel.setOperatorStatus(carol, true);
+        REQUIRE(channel.getNamesList() == "@alice bob @carol");
+        channel.setOperatorStatus(alice, false);
+        REQUIRE(channel.getNamesList() == "alice bob @carol");
+        REQUIRE(channel.getMemberCount() == 3);
+    }
+
+    SECTION("NAMES shows a nickname change where the member stands") {
+        channel.joinMember(bob);
+        alice.setNickname("alicia");
+        channel.refreshMemberName(alice);
+        REQUIRE(channel.getNamesList() == "@alicia bob");
+        bob.setNickname("robert");
+        channel.refreshMemberName(bob);
+        REQUIRE(channel.getNamesList() == "@alicia robert");
+        channel.refreshMemberName(carol);
+        REQUIRE(channel.getNamesList() == "@alicia robert");
+    }
+
+    SECTION("operator status needs membership") {
+        channel.setOperatorStatus(bob, true);
+        REQUIRE_FALSE(channel.isOperator(bob));
+        REQUIRE_FALSE(channel.isMember(bob));
+    }
+
+    SECTION("invitations are independent of membership") {
+        channel.invite(bob);
+        REQUIRE(channel.isInvited(bob));
+        REQUIRE_FALSE(channel.isMember(bob));
+        channel.joinMember(bob);
+        REQUIRE(channel.isMember(bob));
+        REQUIRE(channel.isInvited(bob));
+        channel.uninvite(bob);
+        REQUIRE_FALSE(channel.isInvited(bob));
+        REQUIRE(channel.isMember(bob));
+        channel.invite(carol);
+        channel.uninvite(carol);
+        REQUIRE_FALSE(channel.isInvited(carol));
+    }
+
+    SECTION("parting clears every flag and hands operator status to the first member left") {
+        channel.joinMember(bob);
+        channel.joinMember(carol);
+        channel.invite(carol);
+        REQUIRE(channel.partMember(carol) == 2);
+        REQUIRE_FALSE(channel.isMember(carol));
+        REQUIRE_FALSE(channel.isInvited(carol));
+        REQUIRE(channel.partMember(carol) == CHANNEL_PART_FAILURE);
+        REQUIRE(channel.partMember(alice) == 1);
+        REQUIRE(channel.isOperator(bob));
+        REQUIRE(channel.getNamesList() == "@bob");
+        REQUIRE(bob.isMemberOfChannel(&channel));
+        REQUIRE_FALSE(alice.isMemberOfChannel(&channel));
+        REQUIRE(channel.partMember(bob) == 0);
+        REQUIRE(channels.empty());
+    }
+
+    SECTION("clients hold the channels they joined") {
+        REQUIRE(alice.getMyChannels() == std::vector<Channel*>{&channel});
+        REQUIRE(bob.getMyChannels().empty());
+        channel.joinMember(bob);
+        REQUIRE(bob.isMemberOfChannel(&channel));
+        Channel& other = *channels.insert(bob, "#other");
+        REQUIRE(bob.getMyChannels() == std::vector<Channel*>{&channel, &other});
+        REQUIRE(channel.partMember(bob) == 1);
+        REQUIRE(bob.getMyChannels() == std::vector<Channel*>{&other});
+        REQUIRE_FALSE(bob.isMemberOfChannel(&channel));
+    }
+
+    SECTION("clients are told apart by fd, another copy of a client is the same member") {
+        channel.joinMember(bob);
+        Client bobCopy(bob);
+        channel.invite(bobCopy);
+        REQUIRE(channel.isMember(bobCopy));
+        REQUIRE(channel.isInvited(bob));
+        REQUIRE(channel.partMember(bobCopy) == 1);
+        REQUIRE_FALSE(channel.isMember(bob));
+        REQUIRE(channel.getNamesList() == "@alice");
+    }
+}
+
+TEST_CASE("Channel keeps NAMES in lines that fit a RPL_NAMREPLY_353", "[channel]") {
+    struct sockaddr sockaddr {};
+    ChannelTable channels;
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int fd = 4; fd < 2004; fd++) {
+        clients.emplace_back(new Client(fd, sockaddr));
+        clients.back()->setNickname("member" + std::to_string(fd));
+    }
+    Channel& channel = *channels.insert(*clients[0], "#a-rather-long-channel-name");
+    for (unsigned long index = 1; index < clients.size(); index++) {
+        channel.joinMember(*clients[index]);
+    }
+    // Operators, parts and renames all over the channel
+    for (unsigned long index = 1; index < clients.size(); index += 7) {
+        channel.setOperatorStatus(*clients[index], true);
+    }
+    for (unsigned long index = 2; index < clients.size(); index += 3) {
+        channel.partMember(*clients[index]);
+    }
+    for (unsigned long index = 3; index < clients.size(); index += 5) {
+        clients[index]->setNickname("renamed" + std::to_string(index));
+        channel.refreshMemberName(*clients[index]);
+    }
+
+    // A rename that no longer fits its line moves to the last one, so only compare which names are listed
+    std::vector<std::string> expected;
+    for (Client* member : channel.getMembers()) {
+        expected.push_back((channel.isOperator(*member) ? "@" : "") + member->getNickname());
+    }
+    std::vector<std::string> listed;
+    std::istringstream namesList(channel.getNamesList());
+    for (std::string name; namesList >> name;) {
+        listed.push_back(name);
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(listed.begin(), listed.end());
+    REQUIRE(listed == expected);
+
+    unsigned long filledLines = 0;
+    for (const std::string& line : channel.getNamesLines()) {
+        if (line.empty() == false) {
+            filledLines++;
+            REQUIRE(line.front() != ' ');
+            REQUIRE(line.back() != ' ');
+            std::string reply = RPL_NAMREPLY_353(serverHostname_g, std::string("ninechars"), CHANNEL_SYMBOL_PUBLIC, channel.getName(), line);
+            REQUIRE(reply.size() <= MAX_MSG_LENGTH);
+        }
+    }
+    REQUIRE(filledLines > 1);
+    REQUIRE(channel.getNamesLines().size() <= 2 * filledLines);
+}
+
+TEST_CASE("ChannelTable resolves names under IRC casemapping", "[channel]") {
+    struct sockaddr sockaddr {};
+    ChannelTable channels;
+    Client alice(4, sockaddr);
+    Client bob(5, sockaddr);
+    alice.setNickname("alice");
+    bob.setNickname("bob");
+
+    REQUIRE(channels.empty());
+    REQUIRE(channels.getOrNull("#foo") == nullptr);
+    Channel* channel = channels.insert(alice, "#Foo_1");
+    REQUIRE(channel != nullptr);
+    REQUIRE(channels.size() == 1);
+    REQUIRE(channels.getOrNull("#Foo_1") == channel);
+    REQUIRE(channels.getOrNull("#fOO_1") == channel);
+    REQUIRE(channels.getOrNull("#FOO_1") == channel);
+    REQUIRE(channels.getOrNull("#foo_2") == nullptr);
+    REQUIRE(channel->getName() == "#Foo_1");
+    REQUIRE_FALSE(Channel::isChannelNameFree("#foO_1", channels));
+
+    SECTION("a name taken under another case or an invalid name is refused") {
+        REQUIRE(channels.insert(bob, "#fOO_1") == nullptr);
+        REQUIRE(channels.insert(bob, "foo") == nullptr);
+        REQUIRE(channels.size() == 1);
+        REQUIRE(bob.getMyChannels().empty());
+    }
+
+    SECTION("channels keep their address while others come and go") {
+        for (int index = 0; index < 1000; index++) {
+            REQUIRE(channels.insert(bob, "#c" + std::to_string(index)) != nullptr);
+        }
+        REQUIRE(channels.getOrNull("#FOO_1") == channel);
+        REQUIRE(channels.size() == 1001);
+    }
+
+    SECTION("the last member leaving erases the channel") {
+        REQUIRE(channel->partMember(alice) == 0);
+        REQUIRE(channels.getOrNull("#foo_1") == nullptr);
+        REQUIRE(channels.erase("#foo_1") == FAILURE);
+        REQUIRE(channels.empty());
+    }
+}
+
+TEST_CASE("Channel::sendMessageToNeighbours reaches every neighbour once", "[channel]") {
+    struct sockaddr sockaddr {};
+    ChannelTable channels;
+    Client quitter(4, sockaddr);
+    Client everywhere(5, sockaddr);
+    Client onlyFirst(6, sockaddr);
+    Client stranger(7, sockaddr);
+    quitter.setNickname("quitter");
+    everywhere.setNickname("everywhere");
+    onlyFirst.setNickname("onlyFirst");
+    stranger.setNickname("stranger");
+    Channel& first = *channels.insert(quitter, "#first");
+    Channel& second = *channels.insert(quitter, "#second");
+    Channel& third = *channels.insert(quitter, "#third");
+    first.joinMember(everywhere);
+    second.joinMember(everywhere);
+    third.joinMember(everywhere);
+    first.joinMember(onlyFirst);
+    channels.insert(stranger, "#elsewhere");
+
+    SharedPayload message = std::make_shared<const std::string>(":quitter!u@h QUIT :bye\r\n");
+    Channel::sendMessageToNeighbours(quitter, message);
+    REQUIRE(everywhere.getSendBuffer() == *message);
+    REQUIRE(onlyFirst.getSendBuffer() == *message);
+    REQUIRE(quitter.getSendBuffer().empty());
+    REQUIRE(stranger.getSendBuffer().empty());
+
+    // Every call is a new fanout
+    Channel::sendMessageToNeighbours(quitter, message);
+    REQUIRE(everywhere.getSendBuffer() == *message + *message);
+    Channel::sendMessageToNeighbours(onlyFirst, message);
+    REQUIRE(quitter.getSendBuffer() == *message);
+    REQUIRE(everywhere.getSendBuffer() == *message + *message + *message);
+}
@@ -0,0 +1,115 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include "../../src/channel/NamesList.h"
+
+using namespace irc;
+
+namespace {
+
+std::string joinLines(const NamesList& names) {
+    std::string joined;
+    for (const std::string& line : names.getLines()) {
+        if (line.empty() == false) {
+            joined += (joined.empty() ? "" : " ") + line;
+        }
+    }
+    return joined;
+}
+
+}  // namespace
+
+TEST_CASE("NamesList keeps names in order within its line length", "[channel]") {
+    NamesList names(16);
+    REQUIRE(names.getLines().empty());
+
+    names.set(4, "@alice");
+    names.set(5, "bob");
+    names.set(6, "carol");
+    REQUIRE(names.getLines() == std::vector<std::string>{"@alice bob carol"});
+    REQUIRE(names.size() == 3);
+
+    SECTION("a name that no longer fits starts a new line") {
+        names.set(7, "dave");
+        REQUIRE(names.getLines() == std::vector<std::string>{"@alice bob carol", "dave"});
+    }
+
+    SECTION("a name is replaced where it stands") {
+        names.set(4, "alice");
+        names.set(5, "@bob");
+        REQUIRE(names.getLines() == std::vector<std::string>{"alice @bob carol"});
+        names.set(5, "@bob");
+        REQUIRE(names.getLines() == std::vector<std::string>{"alice @bob carol"});
+    }
+
+    SECTION("a replacement that does not fit moves to the last line") {
+        names.set(7, "dave");
+        names.set(5, "robert");
+        REQUIRE(names.getLines() == std::vector<std::string>{"@alice carol", "dave robert"});
+    }
+
+    SECTION("removing a name removes one space next to it") {
+        names.erase(5);
+        REQUIRE(names.getLines() == std::vector<std::string>{"@alice carol"});
+        names.erase(4);
+        REQUIRE(names.getLines() == std::vector<std::string>{"carol"});
+        names.erase(4);
+        names.erase(6);
+        REQUIRE(names.getLines().empty());
+        REQUIRE(names.size() == 0);
+    }
+}
+
+TEST_CASE("NamesList matches a rendering from scratch after any changes", "[channel]") {
+    const unsigned long maxLineLength = 40;
+    NamesList names(maxLineLength);
+    std::map<int, std::string> model;  // fd -> name, the order is not part of the comparison
+    std::srand(42);
+
+    for (int step = 0; step < 5000; step++) {
+        int fd = std::rand() % 300;
+        bool isErase = std::rand() % 3 == 0;
+        bool wasListed = model.count(fd) != 0;
+        if (isErase) {
+            names.erase(fd);
+            model.erase(fd);
+        } else {
+            std::string name = (std::rand() % 5 == 0 ? "@n" : "n") + std::to_string(fd) + std::string(static_cast<unsigned long>(std::rand() % 6), 'x');
+            names.set(fd, name);
+            model[fd] = name;
+        }
+
+        unsigned long totalLength = 0;
+        for (const std::string& line : names.getLines()) {
+            REQUIRE(line.size() <= maxLineLength);
+            totalLength += line.size();
+        }
+        // Lines emptied by parts are dropped on the part that leaves too many of them
+        if (isErase && wasListed) {
+            REQUIRE(names.getLines().size() <= 2 * (totalLength / maxLineLength + 1));
+        }
+        REQUIRE((names.getLines().empty() || names.getLines().back().empty() == false));
+        REQUIRE(names.size() == model.size());
+        if (step % 100 == 0) {
+            std::vector<std::string> listed;
+            std::string joined = joinLines(names);
+            for (unsigned long start = 0; start < joined.size();) {
+                unsigned long end = joined.find(' ', start);
+                end = end == std::string::npos ? joined.size() : end;
+                listed.push_back(joined.substr(start, end - start));
+                start = end + 1;
+            }
+            std::vector<std::string> expected;
+            for (const std::pair<const int, std::string>& entry : model) {
+                expected.push_back(entry.second);
+            }
+            std::sort(listed.begin(), listed.end());
+            std::sort(expected.begin(), expected.end());
+            REQUIRE(listed == expected);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/socket.h>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../src/client/ClientTable.h"
+
+using namespace irc;
+
+TEST_CASE("Client lookups per event at 50k clients", "[.][benchmark][client]") {
+    const int clients = 50000;
+    struct sockaddr sockaddr {};
+    std::map<int, Client> map;
+    ClientTable table;
+    for (int fd = 5; fd < clients + 5; fd++) {
+        map.insert(std::make_pair(fd, Client(fd, sockaddr)));
+        table.insert(fd, Client(fd, sockaddr));
+    }
+    // The ready descriptors of many wakeups, in no particular order
+    std::vector<int> events;
+    for (int fd = 5; fd < clients + 5; fd++) {
+        events.push_back(fd);
+    }
+    std::shuffle(events.begin(), events.end(), std::mt19937(42));
+
+    BENCHMARK("std::map<int, Client>::at") {
+        long sum = 0;
+        for (int fd : events) {
+            sum += map.at(fd).getFd();
+        }
+        return sum;
+    };
+
+    BENCHMARK("ClientTable::getOrNull") {
+        long sum = 0;
+        for (int fd : events) {
+            sum += table.getOrNull(fd)->getFd();
+        }
+        return sum;
+    };
+    std::cout << "each run looks up " << events.size() << " clients" << std::endl;
+}
+
+// The previous lookup of Command::findClientByNicknameOrThrow: casefold a copy of every nickname until one matches
+static Client* findByScanning(const ClientTable& table, const std::string& nickname) {
+    std::string lowerNickname = nickname;
+    std::transform(lowerNickname.begin(), lowerNickname.end(), lowerNickname.begin(), ::tolower);
+    std::replace(lowerNickname.begin(), lowerNickname.end(), '{', '[');
+    std::replace(lowerNickname.begin(), lowerNickname.end(), '}', ']');
+    std::replace(lowerNickname.begin(), lowerNickname.end(), '|', '\\');
+    std::replace(lowerNickname.begin(), lowerNickname.end(), '^', '~');
+    for (Client* candidate : table) {
+        std::string clientNickname = candidate->getNickname();
+        std::transform(clientNickname.begin(), clientNickname.end(), clientNickname.begin(), ::tolower);
+        std::replace(clientNickname.begin(), clientNickname.end(), '{', '[');
+        std::replace(clientNickname.begin(), clientNickname.end(), '}', ']');
+        std::replace(clientNickname.begin(), clientNickname.end(), '|', '\\');
+        std::replace(clientNickname.begin(), clientNickname.end(), '^', '~');
+        if (clientNickname == lowerNickname) {
+            return candidate;
+        }
+    }
+    return nullptr;
+}
+
+TEST_CASE("Nickname lookups at 100k clients", "[.][benchmark][client]") {
+    const int clients = 100000;
+    struct sockaddr sockaddr {};
+    ClientTable table;
+    std::vector<std::string> targets;
+    for (int fd = 5; fd < clients + 5; fd++) {
+        std::string nickname = "User" + std::to_string(fd - 5);  // at most NICK_MAX_LENGTH_RFC2812 characters
+        table.insert(fd, Client(fd, sockaddr))->setNickname(nickname);
+        targets.push_back(nickname);
+    }
+    std::shuffle(targets.begin(), targets.end(), std::mt19937(42));
+    targets.resize(20);  // the private messages of one wakeup, sent to random users
+
+    BENCHMARK("scan and casefold every nickname") {
+        long found = 0;
+        for (const std::string& target : targets) {
+            found += (findByScanning(table, target) != nullptr) ? 1 : 0;
+        }
+        return found;
+    };
+
+    BENCHMARK("ClientTable::getByNicknameOrNull") {
+        long found = 0;
+        for (const std::string& target : targets) {
+            found += (table.getByNicknameOrNull(target) != nullptr) ? 1 : 0;
+        }
+        return found;
+    };
+    REQUIRE(findByScanning(table, targets[0]) == table.getByNicknameOrNull(targets[0]));
+    std::cout << "each run looks up " << targets.size() << " nicknames among " << table.size() << " clients" << std::endl;
+}
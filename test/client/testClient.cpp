@@ -0,0 +1,60 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <cstring>
+#include <thread>
+#include "../../src/client/Client.h"
+
+using namespace irc;
+
+TEST_CASE("Client keeps its prefix until the nickname or username changes", "[client]") {
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    inet_pton(AF_INET, "10.0.0.7", &address.sin_addr);
+    Client client(5, reinterpret_cast<const struct sockaddr&>(address));
+
+    client.setNickname("nick");
+    client.setUserName("user");
+    REQUIRE(client.getPrefix() == ":nick!user@10.0.0.7");
+    REQUIRE(client.getPrefix() == FORMAT_NICK_USER_HOST(client.getNickname(), client.getUserName(), client.getHost()).toString());
+    REQUIRE(PREFIXED_MESSAGE(client.getPrefix(), "JOIN", "#chan").toString() == COM_MESSAGE("nick", "user", "10.0.0.7", "JOIN", "#chan").toString());
+
+    client.setNickname("other");
+    REQUIRE(client.getPrefix() == ":other!user@10.0.0.7");
+    client.setUserName("name");
+    REQUIRE(client.getPrefix() == ":other!name@10.0.0.7");
+    client.setNickname("longerThanNine");
+    REQUIRE(client.getPrefix() == ":longerTha!name@10.0.0.7");
+
+    Client copy(client);
+    copy.setNickname("copy");
+    REQUIRE(copy.getPrefix() == ":copy!name@10.0.0.7");
+    REQUIRE(client.getPrefix() == ":longerTha!name@10.0.0.7");
+}
+
+TEST_CASE("Client keeps the replies it defers apart from data other threads queue", "[client]") {
+    struct sockaddr address;
+    std::memset(&address, 0, sizeof(address));
+    Client client(5, address);
+    std::vector<int> pendingWrites;
+    client.setPendingWriteQueue(&pendingWrites);
+
+    client.appendToSendBuffer("queued before\r\n");
+    client.deferReplies();
+    client.appendToSendBuffer("PONG\r\n");
+    std::thread otherReactor([&client]() { client.appendToSendBuffer("from another reactor\r\n"); });
+    otherReactor.join();
+    REQUIRE(client.getSendBuffer() == "queued before\r\nfrom another reactor\r\n");
+    REQUIRE(pendingWrites.size() == 1);
+
+    client.unschedulePendingWrite();
+    pendingWrites.clear();
+    client.mergeDeferredReplies();
+    REQUIRE(client.getSendBuffer() == "queued before\r\nfrom another reactor\r\nPONG\r\n");
+    REQUIRE(pendingWrites.size() == 1);
+    client.appendToSendBuffer("not deferred\r\n");
+    REQUIRE(client.getSendBuffer() == "queued before\r\nfrom another reactor\r\nPONG\r\nnot deferred\r\n");
+}
@@ -0,0 +1,113 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/socket.h>
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+#include "../../src/client/ClientTable.h"
+
+using namespace irc;
+
+static std::vector<int> fdsOf(const ClientTable& table) {
+    std::vector<int> fds;
+    for (Client* client : table) {
+        fds.push_back(client->getFd());
+    }
+    std::sort(fds.begin(), fds.end());
+    return fds;
+}
+
+TEST_CASE("ClientTable stores clients by fd", "[client]") {
+    int errno_before = errno;
+    struct sockaddr sockaddr {};
+    ClientTable table;
+
+    REQUIRE(table.empty());
+    REQUIRE(table.getOrNull(0) == nullptr);
+    REQUIRE(table.getOrNull(-1) == nullptr);
+    REQUIRE(table.getOrNull(1000) == nullptr);
+
+    for (int fd = 3; fd < 10; fd++) {
+        Client* inserted = table.insert(fd, Client(fd, sockaddr));
+        REQUIRE(inserted != nullptr);
+        REQUIRE(inserted->getFd() == fd);
+    }
+    REQUIRE(table.size() == 7);
+    REQUIRE(table.insert(5, Client(5, sockaddr)) == nullptr);
+    REQUIRE(table.insert(-1, Client(-1, sockaddr)) == nullptr);
+
+    SECTION("lookups return the stored client") {
+        REQUIRE(table.getOrNull(7)->getFd() == 7);
+        REQUIRE(table.getOrNull(2) == nullptr);
+        REQUIRE(table.getOrNull(10) == nullptr);
+    }
+
+    SECTION("erasing keeps the other clients at the same address") {
+        Client* kept = table.getOrNull(9);
+        kept->setNickname("kept");
+        REQUIRE(table.erase(3) == SUCCESS);
+        REQUIRE(table.erase(6) == SUCCESS);
+        REQUIRE(table.erase(6) == FAILURE);
+        REQUIRE(table.getOrNull(9) == kept);
+        REQUIRE(kept->getNickname() == "kept");
+        REQUIRE(table.size() == 5);
+        REQUIRE(fdsOf(table) == std::vector<int>({4, 5, 7, 8, 9}));
+    }
+
+    SECTION("an erased fd can be reused") {
+        REQUIRE(table.erase(4) == SUCCESS);
+        REQUIRE(table.getOrNull(4) == nullptr);
+        REQUIRE(table.insert(4, Client(4, sockaddr)) != nullptr);
+        REQUIRE(fdsOf(table) == std::vector<int>({3, 4, 5, 6, 7, 8, 9}));
+    }
+
+    SECTION("the table holds copies of the clients it is initialized with") {
+        Client original(1, sockaddr);
+        original.setNickname("original");
+        ClientTable initialized = {{1, original}};
+        REQUIRE(initialized.getOrNull(1) != &original);
+        REQUIRE(initialized.getOrNull(1)->getNickname() == "original");
+    }
+    REQUIRE(errno == errno_before);
+}
+
+TEST_CASE("ClientTable indexes clients by casefolded nickname", "[client]") {
+    int errno_before = errno;
+    struct sockaddr sockaddr {};
+    Client named(1, sockaddr);
+    named.setNickname("Alice");
+    ClientTable table = {{1, named}, {2, Client(2, sockaddr)}};
+    Client* alice = table.getOrNull(1);
+    Client* unnamed = table.getOrNull(2);
+
+    SECTION("nicknames are compared under IRC casemapping") {
+        REQUIRE(casefold("Nick[]\\~{}|^") == "nick[]\\~[]\\~");
+        REQUIRE(table.getByNicknameOrNull("alice") == alice);
+        REQUIRE(table.getByNicknameOrNull("ALICE") == alice);
+        REQUIRE(table.getByNicknameOrNull("bob") == nullptr);
+        REQUIRE(table.getByNicknameOrNull("*") == nullptr);  // the placeholder of clients without a nickname
+        unnamed->setNickname("b{ob}");
+        REQUIRE(table.getByNicknameOrNull("B[OB]") == unnamed);
+    }
+
+    SECTION("a nickname change moves the client in the index") {
+        alice->setNickname("Alicia");
+        REQUIRE(table.getByNicknameOrNull("alice") == nullptr);
+        REQUIRE(table.getByNicknameOrNull("alicia") == alice);
+    }
+
+    SECTION("erasing a client drops its nickname") {
+        REQUIRE(table.erase(1) == SUCCESS);
+        REQUIRE(table.getByNicknameOrNull("alice") == nullptr);
+        REQUIRE(table.insert(1, Client(1, sockaddr))->getNickname() == "*");
+        REQUIRE(table.getByNicknameOrNull("alice") == nullptr);
+    }
+
+    SECTION("a copy of a stored client does not touch the index") {
+        Client copy = *alice;
+        copy.setNickname("copy");
+        REQUIRE(table.getByNicknameOrNull("copy") == nullptr);
+        REQUIRE(table.getByNicknameOrNull("alice") == alice);
+    }
+    REQUIRE(errno == errno_before);
+}
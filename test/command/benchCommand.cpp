@@ -0,0 +1,213 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../../src/client/Client.h"
+#include "../../src/client/ClientTable.h"
+#include "../../src/command/Command.h"
+#include "../../src/message/Message.h"
+#include "../common/allocationCount.h"
+
+using namespace irc;
+
+// Stands in for Command, the actions only count so the benchmark measures the dispatch itself
+struct Dispatcher {
+    void actionA(long& sum) { sum += 1; }
+    void actionB(long& sum) { sum += 2; }
+    void actionC(long& sum) { sum += 3; }
+};
+
+TEST_CASE("Command dispatch cost per message", "[.][benchmark][command]") {
+    // A chatty channel: mostly PRIVMSG, some PING, JOIN, PART, MODE, the odd unknown command
+    const std::vector<std::string> lines = {
+        "PRIVMSG #channel :hello", "PRIVMSG #channel :how are you", "PING :irc.example.com", "PRIVMSG bob :hi",
+        "JOIN #other",             "PRIVMSG #other :hey",           "MODE #other +t",        "PRIVMSG #channel :bye",
+        "PART #other",             "WHO #channel",                  "PRIVMSG #channel :re",  "TOPIC #channel",
+    };
+    std::vector<Message> messages;
+    for (const std::string& line : lines) {
+        messages.push_back(Message(line));
+    }
+
+    // The previous dispatch: the command name copied out of the message, a std::map lookup and a std::function call
+    std::map<std::string, std::function<void(Dispatcher*, long&)>> map;
+    const char* names[] = {"PING", "CHANNEL", "PART", "PASS", "NICK", "USER", "QUIT", "PRIVMSG", "JOIN", "TOPIC", "KICK", "MODE", "INVITE"};
+    int index = 0;
+    for (const char* name : names) {
+        int kind = index++ % 3;
+        map[name] = [kind](Dispatcher* dispatcher, long& sum) {
+            kind == 0 ? dispatcher->actionA(sum) : kind == 1 ? dispatcher->actionB(sum) : dispatcher->actionC(sum);
+        };
+    }
+
+    // The current dispatch: the CommandId resolved by the parser indexes a table of member function pointers
+    void (Dispatcher::*table[COMMAND_COUNT])(long&) = {};
+    for (int id = COMMAND_UNKNOWN + 1; id < COMMAND_COUNT; id++) {
+        table[id] = (id % 3 == 0) ? &Dispatcher::actionA : (id % 3 == 1) ? &Dispatcher::actionB : &Dispatcher::actionC;
+    }
+    table[COMMAND_CAP] = NULL;
+
+    Dispatcher dispatcher;
+    BENCHMARK("std::map<std::string, std::function> find + call") {
+        long sum = 0;
+        for (const Message& message : messages) {
+            std::string commandName = message.getCommand();
+            auto it = map.find(commandName);
+            if (it != map.end()) {
+                it->second(&dispatcher, sum);
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("CommandId table call") {
+        long sum = 0;
+        for (const Message& message : messages) {
+            void (Dispatcher::*handler)(long&) = table[message.getCommandId()];
+            if (handler != NULL) {
+                (dispatcher.*handler)(sum);
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("lookupCommandId alone (done once by the parser)") {
+        long sum = 0;
+        for (const Message& message : messages) {
+            Message::View command = message.getCommandView();
+            sum += lookupCommandId(command.data, command.length);
+        }
+        return sum;
+    };
+    std::cout << "each run dispatches " << messages.size() << " messages" << std::endl;
+}
+
+TEST_CASE("PRIVMSG to nonexistent targets", "[.][benchmark][command]") {
+    struct sockaddr sockaddr {};
+    ClientTable clients;
+    ChannelTable channels;
+    for (int fd = 5; fd < 1005; fd++) {
+        Client* client = clients.insert(fd, Client(fd, sockaddr));
+        client->setNickname("User" + std::to_string(fd - 5));
+    }
+    Client& sender = *clients.getOrNull(5);
+    sender.setPassword("password");
+    sender.setUserName("UserName");
+    for (int index = 0; index < 100; index++) {
+        std::string channelName = "#channel" + std::to_string(index);
+        channels.insert(sender, channelName);
+    }
+    std::string password = "password";
+    time_t serverStartTime = time(NULL);
+    // Half unknown channels, half unknown nicknames, as a client spamming made up targets would send
+    const Message toChannel("PRIVMSG #nochannel :hello");
+    const Message toNickname("PRIVMSG nobody :hello");
+    const std::vector<std::string> targets = {"#nochannel", "nobody"};
+
+    // Constructing a Command executes it
+    auto run = [&](const Message& message) { Command command(message, sender, clients, password, serverStartTime, channels); };
+    run(toChannel);
+    run(toNickname);
+    REQUIRE(sender.getSendBuffer() == RPL_ERR_NOSUCHNICK_401(serverHostname_g, "#nochannel").toString() + RPL_ERR_NOSUCHNICK_401(serverHostname_g, "nobody").toString());
+    sender.clearSendBuffer();
+
+    // The previous misses: a throwing channel and nickname search, each caught to send the 401
+    BENCHMARK("lookup misses reported by exceptions") {
+        long misses = 0;
+        for (const std::string& target : targets) {
+            try {
+                bool found = target[0] == '#' ? channels.getOrNull(target) != nullptr : clients.getByNicknameOrNull(target) != nullptr;
+                if (found == false) {
+                    throw std::out_of_range(target + " not found");
+                }
+            } catch (std::out_of_range& e) {
+                misses++;
+            }
+        }
+        return misses;
+    };
+
+    BENCHMARK("lookup misses reported by null pointers") {
+        long misses = 0;
+        for (const std::string& target : targets) {
+            if (target[0] == '#') {
+                misses += channels.getOrNull(target) == nullptr;
+            } else {
+                misses += clients.getByNicknameOrNull(target) == nullptr;
+            }
+        }
+        return misses;
+    };
+
+    BENCHMARK("Command, two PRIVMSG to nonexistent targets") {
+        run(toChannel);
+        run(toNickname);
+        sender.clearSendBuffer();
+    };
+}
+
+TEST_CASE("Relaying a PRIVMSG", "[.][benchmark][command]") {
+    struct sockaddr sockaddr {};
+    ClientTable clients;
+    ChannelTable channels;
+    Client& sender = *clients.insert(5, Client(5, sockaddr));
+    Client& receiver = *clients.insert(6, Client(6, sockaddr));
+    sender.setPassword("password");
+    sender.setUserName("username");
+    sender.setNickname("sender");
+    receiver.setNickname("receiver");
+    std::string password = "password";
+    time_t serverStartTime = time(NULL);
+    const std::string text = "Hello, how is everyone doing today?";
+    const Message privmsg("PRIVMSG receiver :" + text);
+
+    // The previous line: the prefix concatenated from copies of nickname, username and host for every message
+    auto previousLine = [&]() -> std::string {
+        std::string formattedSender = FORMAT_NICK_USER_HOST(sender.getNickname(), sender.getUserName(), sender.getHost());
+        return PRIVMSG_FORMAT(formattedSender, "receiver", text);
+    };
+    auto currentLine = [&]() -> std::string { return PRIVMSG_FORMAT(sender.getPrefix(), "receiver", text); };
+    REQUIRE(previousLine() == currentLine());
+    { Command command(privmsg, sender, clients, password, serverStartTime, channels); }
+    REQUIRE(receiver.getSendBuffer() == currentLine());
+    receiver.clearSendBuffer();
+
+    long before = allocationCount_g;
+    std::string line = previousLine();
+    long previousAllocations = allocationCount_g - before;
+    before = allocationCount_g;
+    line = currentLine();
+    long currentAllocations = allocationCount_g - before;
+    before = allocationCount_g;
+    { Command command(privmsg, sender, clients, password, serverStartTime, channels); }
+    long commandAllocations = allocationCount_g - before;
+    receiver.clearSendBuffer();
+    // What Command used to copy out of every message before running the action
+    before = allocationCount_g;
+    {
+        std::string commandName = privmsg.getCommand();
+        std::string prefix = privmsg.getPrefix();
+        std::vector<std::string> parameters = privmsg.getParameters();
+    }
+    long copyAllocations = allocationCount_g - before;
+
+    BENCHMARK("line with the prefix rebuilt") {
+        return previousLine().size();
+    };
+
+    BENCHMARK("line with the cached prefix") {
+        return currentLine().size();
+    };
+
+    BENCHMARK("Command relaying the PRIVMSG") {
+        Command command(privmsg, sender, clients, password, serverStartTime, channels);
+        receiver.clearSendBuffer();
+    };
+    std::cout << "allocations building the relayed line: " << previousAllocations << " with the prefix rebuilt, " << currentAllocations
+              << " with the cached prefix; " << commandAllocations << " for the whole Command, which no longer copies the parameters ("
+              << copyAllocations << " allocations)" << std::endl;
+}
@@ -1,8 +1,10 @@
 #include "../catch2/catch_amalgamated.hpp"
 
 #include <cerrno>
+#include <cstring>
 #include <map>
 #include "../../src/client/Client.h"
+#include "../../src/client/ClientTable.h"
 #include "../../src/command/Command.h"
 #include "../../src/message/Message.h"
 
@@ -78,7 +80,7 @@ TEST_CASE("Nick", "[command][nick]") {
     REQUIRE(errno == errno_before);
     time_t serverStartTime = time(NULL);
     struct sockaddr sockaddr;
-    std::map<std::string, Channel> myChannels;
+    ChannelTable myChannels;
     std::string response;
 
     Client client1(1, sockaddr);
@@ -90,7 +92,7 @@ TEST_CASE("Nick", "[command][nick]") {
     client2.setPassword("client2P");
     client2.setUserName("client2U");
     client2.setNickname("client2N");
-    std::map<int, Client> myClients = {{1, client1}, {2, client2}};
+    ClientTable myClients = {{1, client1}, {2, client2}};
 
     GIVEN("A client with a nickname") {
         WHEN("Setting a valid nickname") {
@@ -177,8 +179,8 @@ TEST_CASE("Command PRIVMSG action", "[command][privmsg]") {
     random.setPassword("randomP");
     random.setUserName("randomU");
     random.setNickname("randomN");
-    std::map<int, Client> myClients = {{1, sender}, {2, receiver}, {3, random}};
-    std::map<std::string, Channel> myChannels;
+    ClientTable myClients = {{1, sender}, {2, receiver}, {3, random}};
+    ChannelTable myChannels;
 
     SECTION("PRIVMSG - Valid") {
         std::string response = ":senderN!senderU@" + sender.getHost() + " PRIVMSG receiverN :A valid message!\r\n";
@@ -186,7 +188,7 @@ TEST_CASE("Command PRIVMSG action", "[command][privmsg]") {
         Message msg(msgWithoutParameters);
         Command cmd(msg, sender, myClients, password, serverStartTime, myChannels);
         std::vector<std::string> param_ = msg.getParameters();
-        REQUIRE(myClients.find(2)->second.getSendBuffer() == response);
+        REQUIRE(myClients.getOrNull(2)->getSendBuffer() == response);
         REQUIRE(sender.getSendBuffer() == "");
     }
 
@@ -230,3 +232,25 @@ TEST_CASE("Command PRIVMSG action", "[command][privmsg]") {
         REQUIRE(sender.getSendBuffer() == response);
     }
 }
+
+TEST_CASE("Commands that only touch their sender", "[command]") {
+    struct sockaddr sockaddr;
+    std::memset(&sockaddr, 0, sizeof(sockaddr));
+    Client client(1, sockaddr);
+
+    // Before registration everything but NICK is answered from the client's own state
+    REQUIRE(Command::isSenderOnly(Message("PASS password"), client) == true);
+    REQUIRE(Command::isSenderOnly(Message("USER user 0 * :real"), client) == true);
+    REQUIRE(Command::isSenderOnly(Message("JOIN #channel"), client) == true);
+    REQUIRE(Command::isSenderOnly(Message("NICK nick"), client) == false);
+
+    client.setPassword("password");
+    client.setUserName("user");
+    client.setNickname("nick");
+    REQUIRE(Command::isSenderOnly(Message("PING token"), client) == true);
+    REQUIRE(Command::isSenderOnly(Message("QUIT :bye"), client) == true);
+    REQUIRE(Command::isSenderOnly(Message("WHOIS nick"), client) == true);
+    REQUIRE(Command::isSenderOnly(Message("JOIN #channel"), client) == false);
+    REQUIRE(Command::isSenderOnly(Message("PRIVMSG nick :hi"), client) == false);
+    REQUIRE(Command::isSenderOnly(Message("NICK other"), client) == false);
+}
@@ -3,6 +3,7 @@
 #include <cerrno>
 #include <map>
 #include "../../src/client/Client.h"
+#include "../../src/client/ClientTable.h"
 #include "../../src/command/Command.h"
 #include "../../src/message/Message.h"
 
@@ -23,8 +24,8 @@ TEST_CASE("Command initialization", "[command][initialization]") {
     struct sockaddr sockaddr {};
 
     Client client(dummyFd, sockaddr);
-    std::map<int, Client> clients{{1, client}};
-    std::map<std::string, Channel> channels;
+    ClientTable clients{{1, client}};
+    ChannelTable channels;
     time_t serverStartTime = time(NULL);
     std::string password = "password";
     errno_before = errno;
@@ -89,8 +90,8 @@ TEST_CASE("Command constructor validation tests", "[Command][constructorValidati
     struct sockaddr sockaddr {};
 
     Client client(dummyFd, sockaddr);
-    std::map<int, Client> allClients{{1, client}};
-    std::map<std::string, Channel> allChannels;
+    ClientTable allClients{{1, client}};
+    ChannelTable allChannels;
     std::string password = "password";
     time_t serverStartTime = time(NULL);
     Message message("NICK newNick");  // Test with valid inputs
@@ -118,8 +119,8 @@ void executeAndValidateCommand(Client& client, const std::string& commandStr, co
     client.clearSendBuffer();
     Message message(commandStr);
     std::string password = "password";
-    std::map<int, Client> myClients = {{1, client}};
-    std::map<std::string, Channel> myChannels;
+    ClientTable myClients = {{1, client}};
+    ChannelTable myChannels;
     Command cmd(message, client, myClients, password, serverStartTime, myChannels);
     REQUIRE(errno_before == errno);
     REQUIRE(client.getSendBuffer() == expectedResponse);
@@ -232,3 +233,33 @@ TEST_CASE("Command::execute tests", "[Command][execute]") {
         executeAndValidateCommand(client, "CAP", ": 421 CAP :Unknown command\r\n", false);
     }
 }
+
+TEST_CASE("Channel commands follow IRC casemapping and echo the channel's own names", "[Command][execute]") {
+    struct sockaddr sockaddr {};
+    ClientTable clients;
+    ChannelTable channels;
+    std::string password = "password";
+    time_t serverStartTime = time(NULL);
+    Client& alice = *clients.insert(4, Client(4, sockaddr));
+    Client& bob = *clients.insert(5, Client(5, sockaddr));
+    const char* nicknames[] = {"alice", "Bob"};
+    Client* members[] = {&alice, &bob};
+    for (int index = 0; index < 2; index++) {
+        members[index]->setPassword(password);
+        members[index]->setUserName("user");
+        members[index]->setNickname(nicknames[index]);
+    }
+    auto run = [&](Client& sender, const std::string& line) { Command command(Message(line), sender, clients, password, serverStartTime, channels); };
+    run(alice, "JOIN #Foo");
+    run(bob, "JOIN #foo");
+    alice.clearSendBuffer();
+    bob.clearSendBuffer();
+
+    run(alice, "MODE #FOO +o BOB");
+    REQUIRE(channels.getOrNull("#foo")->isOperator(bob));
+    REQUIRE(bob.getSendBuffer() == ":alice!user@" + alice.getHost() + " MODE #Foo +o Bob\r\n");
+    alice.clearSendBuffer();
+
+    run(bob, "PRIVMSG #FOO :hi");
+    REQUIRE(alice.getSendBuffer() == ":Bob!user@" + bob.getHost() + " PRIVMSG #Foo :hi\r\n");
+}
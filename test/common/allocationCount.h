@@ -0,0 +1,9 @@
+#ifndef ALLOCATIONCOUNT_H
+#define ALLOCATIONCOUNT_H
+
+#include <atomic>
+
+// Every heap allocation of the test binary is counted, only look at the difference around the code measured
+extern std::atomic<long> allocationCount_g;
+
+#endif
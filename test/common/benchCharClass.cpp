@@ -0,0 +1,53 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <regex>
+#include <string>
+#include <vector>
+#include "../../src/common/charclass.h"
+
+using namespace irc;
+
+TEST_CASE("Nickname and channel name validation: std::regex vs character class table", "[.][benchmark][charclass]") {
+    const std::vector<std::string> nicknames = {"nick", "UserNick", "[away]", "bad*nick", "9lives", "a_very-long"};
+    const std::vector<std::string> channelNames = {"#channel", "&local", "#a", "#with space", "#lobby-42", "nochannel"};
+
+    // What Command::isValidNickname and Channel::isChannelNameValid did on every call: compile, then match
+    BENCHMARK("std::regex compiled per call") {
+        long valid = 0;
+        for (const std::string& nickname : nicknames) {
+            std::regex pattern(R"(^[a-zA-Z\[\]\\`_^{|}])");
+            std::regex pattern1(R"(^[a-zA-Z0-9\[\]\\`_^{|}-]*$)");
+            valid += std::regex_match(nickname.substr(0, 1), pattern) && std::regex_match(nickname, pattern1);
+        }
+        for (const std::string& channelName : channelNames) {
+            std::regex pattern(R"(^[&#][a-zA-Z0-9_-]+$)", std::regex::icase);
+            valid += std::regex_match(channelName, pattern);
+        }
+        return valid;
+    };
+
+    static const std::regex nicknameFirst(R"(^[a-zA-Z\[\]\\`_^{|}])");
+    static const std::regex nicknameRest(R"(^[a-zA-Z0-9\[\]\\`_^{|}-]*$)");
+    static const std::regex channel(R"(^[&#][a-zA-Z0-9_-]+$)", std::regex::icase);
+    BENCHMARK("std::regex compiled once") {
+        long valid = 0;
+        for (const std::string& nickname : nicknames) {
+            valid += std::regex_match(nickname.substr(0, 1), nicknameFirst) && std::regex_match(nickname, nicknameRest);
+        }
+        for (const std::string& channelName : channelNames) {
+            valid += std::regex_match(channelName, channel);
+        }
+        return valid;
+    };
+
+    BENCHMARK("character class table") {
+        long valid = 0;
+        for (const std::string& nickname : nicknames) {
+            valid += matchesNicknamePattern(nickname.data(), nickname.size());
+        }
+        for (const std::string& channelName : channelNames) {
+            valid += matchesChannelNamePattern(channelName.data(), channelName.size());
+        }
+        return valid;
+    };
+}
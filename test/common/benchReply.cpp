@@ -0,0 +1,62 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <iostream>
+#include <string>
+#include "../../src/buffer/SendQueue.h"
+#include "../../src/common/reply.h"
+#include "allocationCount.h"
+
+using namespace irc;
+
+// The previous macros: a chain of std::string operator+, every step a temporary of its own
+#define PREVIOUS_RPL_META_MESSAGE(servername, numeric, message) (std::string(":") + servername + " " + numeric + " " + message + "\r\n")
+#define PREVIOUS_RPL_ERR_NEEDMOREPARAMS_461(servername, client, command) \
+    (PREVIOUS_RPL_META_MESSAGE(servername, "461", client + " " + command + " :Not enough parameters"))
+#define PREVIOUS_PREFIXED_MESSAGE(prefix, command, params) (std::string(prefix) + " " + command + " " + params + "\r\n")
+
+TEST_CASE("Replies queued for a client: operator+ chains vs ReplyBuilder", "[.][benchmark][reply]") {
+    const std::string servername = "irc.example.com";
+    const std::string nickname = "xuffy";
+    const std::string prefix = ":xuffy!markus@123.123.123.123";
+    const std::string channel = "#test";
+    const std::string text = "Hello, how is everyone doing today?";
+    SendQueue queue;
+
+    // The queue already holds a chunk with room, as it does for a client that is being answered
+    auto previousReplies = [&]() {
+        queue.append(PREVIOUS_RPL_ERR_NEEDMOREPARAMS_461(servername, nickname, "MODE"));
+        queue.append(PREVIOUS_PREFIXED_MESSAGE(prefix, "PRIVMSG", channel + " :" + text));
+    };
+    auto currentReplies = [&]() {
+        queue.append(RPL_ERR_NEEDMOREPARAMS_461(servername, nickname, "MODE"));
+        queue.append(PREFIXED_MESSAGE(prefix, "PRIVMSG", channel, " :", text));
+    };
+    previousReplies();
+    std::string previousOutput = queue.toString();
+    queue.clear();
+    currentReplies();
+    REQUIRE(queue.toString() == previousOutput);
+
+    long before = allocationCount_g;
+    previousReplies();
+    long previousAllocations = allocationCount_g - before;
+    before = allocationCount_g;
+    currentReplies();
+    long currentAllocations = allocationCount_g - before;
+
+    BENCHMARK("operator+ chains, copied into the queue") {
+        queue.clear();
+        queue.append(":irc PONG irc\r\n");
+        previousReplies();
+        return queue.size();
+    };
+
+    BENCHMARK("ReplyBuilder, written into the queue") {
+        queue.clear();
+        queue.append(":irc PONG irc\r\n");
+        currentReplies();
+        return queue.size();
+    };
+    std::cout << "allocations queueing a 461 and a PRIVMSG: " << previousAllocations << " with operator+ chains, " << currentAllocations
+              << " with ReplyBuilder" << std::endl;
+}
@@ -0,0 +1,78 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../../src/common/charclass.h"
+
+using namespace irc;
+
+// The patterns Command::isValidNickname and Channel::isChannelNameValid used to match with
+static bool regexMatchesNickname(const std::string& name) {
+    static const std::regex pattern(R"(^[a-zA-Z\[\]\\`_^{|}])");
+    static const std::regex pattern1(R"(^[a-zA-Z0-9\[\]\\`_^{|}-]*$)");
+    return std::regex_match(name.substr(0, 1), pattern) && std::regex_match(name, pattern1);
+}
+
+static bool regexMatchesChannelName(const std::string& name) {
+    static const std::regex pattern(R"(^[&#][a-zA-Z0-9_-]+$)", std::regex::icase);
+    return std::regex_match(name, pattern);
+}
+
+static void checkAgainstRegex(const std::string& name) {
+    INFO("name of " << name.size() << " bytes: " << name);
+    CHECK(matchesNicknamePattern(name.data(), name.size()) == regexMatchesNickname(name));
+    CHECK(matchesChannelNamePattern(name.data(), name.size()) == regexMatchesChannelName(name));
+}
+
+TEST_CASE("Character class validators accept exactly what the regexes accepted", "[charclass]") {
+    SECTION("every string of up to two bytes") {
+        checkAgainstRegex("");
+        for (int first = 0; first < 256; first++) {
+            checkAgainstRegex(std::string(1, static_cast<char>(first)));
+            for (int second = 0; second < 256; second++) {
+                std::string name(1, static_cast<char>(first));
+                name += static_cast<char>(second);
+                checkAgainstRegex(name);
+            }
+        }
+    }
+
+    SECTION("random strings drawn mostly from the valid characters") {
+        const std::string alphabet = std::string("azAZ09[]\\`_^{|}-#&~ ,:.*?!@$\t\r\n\x7f\x80\xc3\xa9\xff") + std::string(1, '\0');
+        std::mt19937 generator(2812);
+        std::uniform_int_distribution<unsigned long> lengthDistribution(0, 60);
+        std::uniform_int_distribution<unsigned long> charDistribution(0, alphabet.size() - 1);
+        std::uniform_int_distribution<int> validDistribution(0, 9);
+        for (int sample = 0; sample < 20000; sample++) {
+            std::string name(lengthDistribution(generator), ' ');
+            for (char& c : name) {
+                c = alphabet[charDistribution(generator)];
+            }
+            // A random string is almost never valid, so most samples get an invalid byte at most
+            if (validDistribution(generator) < 7 && name.size() > 0) {
+                name[0] = (sample % 2 == 0) ? '#' : 'n';
+                for (unsigned long i = 1; i < name.size(); i++) {
+                    if (validDistribution(generator) != 0) {
+                        name[i] = alphabet[charDistribution(generator) % 17];
+                    }
+                }
+            }
+            checkAgainstRegex(name);
+        }
+    }
+
+    SECTION("known names") {
+        CHECK(matchesNicknamePattern("nick", 4));
+        CHECK(matchesNicknamePattern("[a]-9", 5));
+        CHECK_FALSE(matchesNicknamePattern("9nick", 5));
+        CHECK_FALSE(matchesNicknamePattern("-nick", 5));
+        CHECK_FALSE(matchesNicknamePattern("", 0));
+        CHECK(matchesChannelNamePattern("#chan_1-2", 9));
+        CHECK(matchesChannelNamePattern("&A", 2));
+        CHECK_FALSE(matchesChannelNamePattern("#", 1));
+        CHECK_FALSE(matchesChannelNamePattern("#a b", 4));
+        CHECK_FALSE(matchesChannelNamePattern("+chan", 5));
+    }
+}
@@ -1,4 +1,27 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <string>
+#include "allocationCount.h"
 
-bool isServerRunning_g = false;
-std::string serverHostname_g;
\ No newline at end of file
+std::atomic<bool> isServerRunning_g(false);
+std::string serverHostname_g;
+
+std::atomic<long> allocationCount_g(0);
+
+void* operator new(std::size_t size) {
+    allocationCount_g++;
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
@@ -95,10 +95,13 @@ TEST_CASE("Replies are known valid strings", "[reply]") {
         REQUIRE(actual_rpl_inviting_341 == expected_rpl_inviting_341);
     }
 
-    SECTION("numeric replies 353") {
+    SECTION("numeric replies 353 and 366") {
         const std::string actual_rpl_namreply_353 = RPL_NAMREPLY_353(server_name, client_nick, "=", channel, "xuffy markus");
         const std::string expected_rpl_namreply_353 = ":irc.example.com 353 xuffy = #test :xuffy markus\r\n";
         REQUIRE(actual_rpl_namreply_353 == expected_rpl_namreply_353);
+        const std::string actual_rpl_endofnames_366 = RPL_ENDOFNAMES_366(server_name, client_nick, channel);
+        const std::string expected_rpl_endofnames_366 = ":irc.example.com 366 xuffy #test :End of NAMES list\r\n";
+        REQUIRE(actual_rpl_endofnames_366 == expected_rpl_endofnames_366);
     }
 
     SECTION("numeric replies 401") {
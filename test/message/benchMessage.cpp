@@ -0,0 +1,81 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../src/message/Message.h"
+#include "../common/allocationCount.h"
+
+using namespace irc;
+
+// The previous parser: an istringstream, operator>> for prefix and command and std::getline per parameter
+struct StreamMessage {
+    std::string prefix;
+    std::string command;
+    std::vector<std::string> parameters;
+
+    explicit StreamMessage(const std::string& serializedMessage) {
+        std::istringstream stream(serializedMessage);
+        if (stream.peek() == ':') {
+            stream >> prefix;
+        }
+        stream >> command;
+        std::transform(command.begin(), command.end(), command.begin(), ::toupper);
+        std::string parameter;
+        stream >> std::ws;
+        while (std::getline(stream, parameter, ' ')) {
+            if (parameter[0] == ':') {
+                std::string trailingParameter;
+                std::getline(stream, trailingParameter);
+                parameters.push_back(trailingParameter.empty() ? parameter : parameter + " " + trailingParameter);
+                break;
+            }
+            parameters.push_back(parameter);
+        }
+    }
+};
+
+TEST_CASE("Message parsing: stream parser vs single-pass parser", "[.][benchmark][message]") {
+    const std::vector<std::string> lines = {
+        "PRIVMSG #channel :Hello everyone, how is it going today?",
+        ":nick!~user@host.com PRIVMSG #channel :Hello, World!",
+        "privmsg  someone  :lower case  and double  spaces ",
+        "MODE #channel +kl secret 10",
+        "JOIN #a,#b,#c key1,key2",
+        "NICK nickname",
+        "PING :irc.example.com",
+        ":prefix-only",
+        "",
+        "QUIT :",
+        "TOPIC #channel :new topic\nwith a newline",
+    };
+    for (const std::string& line : lines) {
+        StreamMessage expected(line);
+        Message message(line);
+        CHECK(message.getPrefix() == expected.prefix);
+        CHECK(message.getCommand() == expected.command);
+        CHECK(message.getParameters() == expected.parameters);
+    }
+
+    const std::string privmsg = lines[0];
+    long before = allocationCount_g;
+    { StreamMessage message(privmsg); }
+    long streamAllocations = allocationCount_g - before;
+    before = allocationCount_g;
+    { Message message(privmsg); }
+    long messageAllocations = allocationCount_g - before;
+    REQUIRE(messageAllocations == 0);
+
+    BENCHMARK("istringstream + getline") {
+        StreamMessage message(privmsg);
+        return message.parameters.size();
+    };
+
+    BENCHMARK("Message") {
+        Message message(privmsg);
+        return message.getParameterCount();
+    };
+    std::cout << "heap allocations per PRIVMSG parse: " << streamAllocations << " before, " << messageAllocations << " now" << std::endl;
+}
@@ -1,6 +1,7 @@
 #include "../catch2/catch_amalgamated.hpp"
 
 #include <cerrno>
+#include <string>
 #include "../../src/message/Message.h"
 
 using namespace irc;
@@ -60,6 +61,17 @@ TEST_CASE("Message deserialization", "[message]") {
         REQUIRE(errno == errno_before);
     }
 
+    SECTION("Input framed as too long by the receive buffer") {
+        RecvBuffer buffer;
+        RecvBuffer::Line line;
+        buffer.append("PRIVMSG #channel :" + std::string(MAX_MSG_LENGTH, 'a') + "\r\n");
+        REQUIRE(buffer.nextLine(line) == true);
+        Message msg(line);
+        REQUIRE(msg.getCommand() == "PRIVMSG");
+        REQUIRE(msg.getNumeric() == ERR_INPUTTOOLONG);
+        REQUIRE(errno == errno_before);
+    }
+
     SECTION("Input contains NULL char") {
         std::string message = ":nick!~user@host.com PRIVMSG #channel :Hello, ";
         message.push_back('\0');
@@ -70,4 +82,42 @@ TEST_CASE("Message deserialization", "[message]") {
         REQUIRE(msg.getNumeric() == ERR_CUSTOM_ILLEGALNUL);
         REQUIRE(errno == errno_before);
     }
+
+    SECTION("Parameters are split on single spaces and the trailing one keeps its colon") {
+        Message msg("mode  #channel +k  key :with  two  spaces");
+        REQUIRE(msg.getCommand() == "MODE");
+        std::vector<std::string> parameters = msg.getParameters();
+        REQUIRE(parameters.size() == 5);
+        REQUIRE(parameters[0] == "#channel");
+        REQUIRE(parameters[1] == "+k");
+        REQUIRE(parameters[2] == "");
+        REQUIRE(parameters[3] == "key");
+        REQUIRE(parameters[4] == ":with  two  spaces");
+        REQUIRE(msg.getNumeric() == 0);
+    }
+
+    SECTION("Views point into the message and survive a copy") {
+        Message original("PRIVMSG #channel :hi");
+        Message msg(original);
+        REQUIRE(msg.getCommandView().equals("PRIVMSG"));
+        REQUIRE(msg.getParameterCount() == 2);
+        REQUIRE(msg.getParameterView(0).toString() == "#channel");
+        REQUIRE(msg.getParameterView(1).equals(":hi"));
+        REQUIRE(msg.getParameterView(2).length == 0);
+        REQUIRE(msg.getPrefixView().length == 0);
+    }
+
+    SECTION("The command is resolved to a CommandId") {
+        REQUIRE(Message("privmsg #channel :hi").getCommandId() == COMMAND_PRIVMSG);
+        REQUIRE(Message(":nick CAP LS").getCommandId() == COMMAND_CAP);
+        for (int id = COMMAND_UNKNOWN + 1; id < COMMAND_COUNT; id++) {
+            REQUIRE(Message(std::string(commandNames[id].name) + " x").getCommandId() == id);
+        }
+        // same slot as a known name, or a known name as a prefix
+        const char* unknown[] = {"PONG", "PINGX", "PRIVMS", "QUIET", "WHO", "", ":prefix-only", "001"};
+        for (const char* line : unknown) {
+            INFO(line);
+            REQUIRE(Message(line).getCommandId() == COMMAND_UNKNOWN);
+        }
+    }
 }
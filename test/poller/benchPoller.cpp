@@ -0,0 +1,105 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <sys/poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "../../src/poller/PollPoller.h"
+#include "../../src/poller/Poller.h"
+
+using namespace irc;
+
+static double cpuTimeMs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+/**
+ * Simulates an idle server: every client socket is writable and nobody sends anything.
+ * Returns the amount of wakeups during the given wall clock time, with each wait()
+ * bounded by a 10ms timeout like a real server with timers would use.
+ */
+static long idleWakeups(Poller::Backend backend, bool alwaysArmWrite, int clients, int durationMs, double& cpuMs) {
+    std::unique_ptr<Poller> poller = Poller::create(backend);
+    std::vector<int> fds;
+    for (int i = 0; i < clients; i++) {
+        int pair[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+        fds.push_back(pair[0]);
+        fds.push_back(pair[1]);
+        REQUIRE(poller->add(pair[0], alwaysArmWrite) == SUCCESS);
+    }
+    std::vector<Poller::Event> events;
+    long wakeups = 0;
+    double cpuStart = cpuTimeMs();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(durationMs);
+    while (std::chrono::steady_clock::now() < end) {
+        if (poller->wait(events, 10) > 0) {
+            wakeups++;
+        }
+    }
+    cpuMs = cpuTimeMs() - cpuStart;
+    for (int fd : fds) {
+        close(fd);
+    }
+    return wakeups;
+}
+
+TEST_CASE("Idle wakeups with permanent vs on-demand write interest", "[.][benchmark][poller]") {
+    const int clients = 200;
+    const int durationMs = 1000;
+    Poller::Backend backends[] = {Poller::BACKEND_POLL, Poller::BACKEND_EPOLL};
+
+    for (Poller::Backend backend : backends) {
+        double alwaysCpuMs;
+        double onDemandCpuMs;
+        long always = idleWakeups(backend, true, clients, durationMs, alwaysCpuMs);
+        long onDemand = idleWakeups(backend, false, clients, durationMs, onDemandCpuMs);
+        std::cout << "[" << Poller::getBackendName(backend) << "] " << clients << " idle clients, " << durationMs << "ms:" << std::endl
+                  << "  POLLOUT always armed: " << always << " wakeups/s, " << alwaysCpuMs << " ms cpu" << std::endl
+                  << "  POLLOUT on demand:    " << onDemand << " wakeups/s, " << onDemandCpuMs << " ms cpu" << std::endl;
+        REQUIRE(onDemand < always);
+    }
+}
+
+// The previous PollPoller::remove(): linear search, then erase() shifting every later entry
+static void eraseFromVector(std::vector<pollfd>& pollfds, int fd) {
+    for (std::vector<pollfd>::iterator it = pollfds.begin(); it != pollfds.end(); it++) {
+        if (it->fd == fd) {
+            pollfds.erase(it);
+            return;
+        }
+    }
+}
+
+TEST_CASE("Mass disconnect: removing every client from the poll set", "[.][benchmark][poller]") {
+    const int counts[] = {1000, 10000, 50000};
+
+    for (int count : counts) {
+        // add() does not touch the descriptors, plain numbers are enough to measure the bookkeeping
+        std::vector<pollfd> pollfds;
+        PollPoller poller;
+        for (int fd = 0; fd < count; fd++) {
+            pollfd entry = {fd, POLLIN, 0};
+            pollfds.push_back(entry);
+            poller.add(fd, false);
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int fd = 0; fd < count; fd++) {
+            eraseFromVector(pollfds, fd);
+        }
+        double eraseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (int fd = 0; fd < count; fd++) {
+            poller.remove(fd);
+        }
+        double swapMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << count << " clients: find + erase " << eraseMs << " ms, indexed swap-remove " << swapMs << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,230 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../src/poller/Poller.h"
+
+using namespace irc;
+
+static void testPollerBackend(Poller::Backend backend) {
+    int errno_before = errno;
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    std::unique_ptr<Poller> poller = Poller::create(backend);
+    std::vector<Poller::Event> events;
+
+    REQUIRE(poller->add(fds[0], false) == SUCCESS);
+    REQUIRE(poller->wait(events, 0) == 0);
+    REQUIRE(events.empty());
+
+    REQUIRE(write(fds[1], "PING\r\n", 6) == 6);
+    REQUIRE(poller->wait(events, 100) == 1);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].fd == fds[0]);
+    REQUIRE(events[0].readable == true);
+    REQUIRE(events[0].writable == false);
+    REQUIRE(events[0].error == false);
+
+    REQUIRE(poller->modify(fds[0], true) == SUCCESS);
+    REQUIRE(poller->wait(events, 100) == 1);
+    REQUIRE(events[0].readable == true);
+    REQUIRE(events[0].writable == true);
+
+    REQUIRE(poller->remove(fds[0]) == SUCCESS);
+    REQUIRE(poller->wait(events, 0) == 0);
+    REQUIRE(events.empty());
+
+    close(fds[0]);
+    close(fds[1]);
+    REQUIRE(errno == errno_before);
+}
+
+TEST_CASE("Poller reports only ready descriptors", "[poller]") {
+    SECTION("poll backend") {
+        testPollerBackend(Poller::BACKEND_POLL);
+    }
+
+    SECTION("epoll backend (falls back to poll where unavailable)") {
+        testPollerBackend(Poller::BACKEND_EPOLL);
+    }
+
+    SECTION("io_uring backend (falls back to the default where unavailable)") {
+        testPollerBackend(Poller::BACKEND_URING);
+    }
+
+    SECTION("backend names") {
+        Poller::Backend backend;
+        REQUIRE(Poller::parseBackend("poll", backend) == SUCCESS);
+        REQUIRE(backend == Poller::BACKEND_POLL);
+        REQUIRE(Poller::parseBackend("epoll", backend) == SUCCESS);
+        REQUIRE(backend == Poller::BACKEND_EPOLL);
+        REQUIRE(Poller::parseBackend("io_uring", backend) == SUCCESS);
+        REQUIRE(backend == Poller::BACKEND_URING);
+        REQUIRE(Poller::getBackendName(Poller::BACKEND_URING) == "io_uring");
+        REQUIRE(Poller::parseBackend("select", backend) == FAILURE);
+        REQUIRE(Poller::getBackendName(Poller::BACKEND_EPOLL) == "epoll");
+    }
+}
+
+static void testRemovalOrder(Poller::Backend backend) {
+    int errno_before = errno;
+    std::unique_ptr<Poller> poller = Poller::create(backend);
+    std::vector<int> watched;
+    std::vector<int> peers;
+    for (int i = 0; i < 8; i++) {
+        int fds[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        REQUIRE(poller->add(fds[0], false) == SUCCESS);
+        watched.push_back(fds[0]);
+        peers.push_back(fds[1]);
+    }
+    REQUIRE(poller->add(watched[0], false) == FAILURE);
+
+    // Remove the first, a middle and the last registration
+    int removed[] = {watched[0], watched[4], watched[7]};
+    for (int fd : removed) {
+        REQUIRE(poller->remove(fd) == SUCCESS);
+    }
+    REQUIRE(poller->remove(watched[4]) == FAILURE);
+    REQUIRE(poller->modify(watched[4], true) == FAILURE);
+    REQUIRE(poller->modify(watched[6], true) == SUCCESS);
+
+    for (int peer : peers) {
+        REQUIRE(write(peer, "x", 1) == 1);
+    }
+    std::vector<Poller::Event> events;
+    REQUIRE(poller->wait(events, 100) == 5);
+    std::vector<int> ready;
+    for (const Poller::Event& event : events) {
+        ready.push_back(event.fd);
+        REQUIRE(event.writable == (event.fd == watched[6]));
+    }
+    std::sort(ready.begin(), ready.end());
+    std::vector<int> expected = {watched[1], watched[2], watched[3], watched[5], watched[6]};
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(ready == expected);
+
+    REQUIRE(poller->add(watched[4], false) == SUCCESS);
+    REQUIRE(poller->wait(events, 100) == 6);
+
+    for (unsigned long i = 0; i < watched.size(); i++) {
+        close(watched[i]);
+        close(peers[i]);
+    }
+    errno = errno_before;  // the failing registrations above set errno on purpose
+}
+
+TEST_CASE("Poller registrations stay consistent when removed in any order", "[poller]") {
+    SECTION("poll backend") {
+        testRemovalOrder(Poller::BACKEND_POLL);
+    }
+
+    SECTION("epoll backend (falls back to poll where unavailable)") {
+        testRemovalOrder(Poller::BACKEND_EPOLL);
+    }
+
+    SECTION("io_uring backend (falls back to the default where unavailable)") {
+        testRemovalOrder(Poller::BACKEND_URING);
+    }
+}
+
+static std::vector<Poller::Event> waitFor(Poller& poller, int fd) {
+    std::vector<Poller::Event> events;
+    for (int attempt = 0; attempt < 10; attempt++) {
+        poller.wait(events, 100);
+        for (const Poller::Event& event : events) {
+            if (event.fd == fd) {
+                return events;
+            }
+        }
+    }
+    return events;
+}
+
+TEST_CASE("io_uring poller does the I/O of connections and listeners itself", "[poller]") {
+    int errno_before = errno;
+    std::unique_ptr<Poller> poller = Poller::create(Poller::BACKEND_URING);
+    if (poller->getBackend() != Poller::BACKEND_URING) {
+        SKIP("io_uring is not available");
+    }
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(listenFd > 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof address;
+    REQUIRE(bind(listenFd, reinterpret_cast<struct sockaddr*>(&address), sizeof address) == 0);
+    REQUIRE(listen(listenFd, 16) == 0);
+    REQUIRE(getsockname(listenFd, reinterpret_cast<struct sockaddr*>(&address), &addressLength) == 0);
+    REQUIRE(poller->addListener(listenFd) == SUCCESS);
+
+    int peer = socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(connect(peer, reinterpret_cast<struct sockaddr*>(&address), sizeof address) == 0);
+    std::vector<Poller::Event> events = waitFor(*poller, listenFd);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].completed == true);
+    int connection = static_cast<int>(events[0].result);
+    REQUIRE(connection > 0);
+    REQUIRE(poller->addConnection(connection) == SUCCESS);
+
+    SECTION("received data comes with the event") {
+        REQUIRE(write(peer, "PING a\r\n", 8) == 8);
+        events = waitFor(*poller, connection);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].readable == true);
+        REQUIRE(events[0].completed == true);
+        REQUIRE(std::string(events[0].data, static_cast<unsigned long>(events[0].result)) == "PING a\r\n");
+
+        shutdown(peer, SHUT_WR);
+        events = waitFor(*poller, connection);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].readable == true);
+        REQUIRE(events[0].result == 0);  // orderly shutdown
+    }
+
+    SECTION("sends are queued, one at a time per connection") {
+        std::string first = "first\r\n";
+        std::string second = "second\r\n";
+        struct iovec iovec = {const_cast<char*>(first.data()), first.size()};
+        REQUIRE(poller->send(connection, &iovec, 1) == static_cast<long long>(first.size()));
+        iovec.iov_base = const_cast<char*>(second.data());
+        iovec.iov_len = second.size();
+        REQUIRE(poller->send(connection, &iovec, 1) == SEND_FAILURE);  // the first one is still queued
+        REQUIRE(errno == EAGAIN);
+        events = waitFor(*poller, connection);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].writable == true);
+        REQUIRE(poller->send(connection, &iovec, 1) == static_cast<long long>(second.size()));
+        waitFor(*poller, connection);
+        char received[32];
+        REQUIRE(recv(peer, received, sizeof received, 0) == static_cast<long>(first.size() + second.size()));
+        REQUIRE(std::string(received, first.size() + second.size()) == first + second);
+    }
+
+    SECTION("removing a connection releases the socket on close") {
+        REQUIRE(poller->remove(connection) == SUCCESS);
+        REQUIRE(poller->remove(connection) == FAILURE);
+        close(connection);
+        connection = -1;
+        char byte;
+        REQUIRE(recv(peer, &byte, 1, 0) == 0);
+    }
+
+    if (connection != -1) {
+        close(connection);
+    }
+    close(peer);
+    close(listenFd);
+    errno = errno_before;  // EAGAIN and ENOENT above are expected
+}
@@ -0,0 +1,391 @@
+#include "../catch2/catch_amalgamated.hpp"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/poll.h>
+#include <sys/ptrace.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../src/server/Server.h"
+
+static int connectTo(const char* port) {
+    struct addrinfo hints;
+    struct addrinfo* info;
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo("127.0.0.1", port, &hints, &info) != 0) {
+        return -1;
+    }
+    int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd != -1 && connect(fd, info->ai_addr, info->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(info);
+    return fd;
+}
+
+static std::vector<int> reconnectStorm(const char* port, int clients) {
+    std::vector<int> fds;
+    for (int i = 0; i < clients; i++) {
+        fds.push_back(connectTo(port));
+        REQUIRE(fds.back() > 0);
+    }
+    return fds;
+}
+
+static void closeAll(std::vector<int>& fds) {
+    for (int fd : fds) {
+        close(fd);
+    }
+    fds.clear();
+}
+
+// The previous accept path: one poll() wakeup, one accept() and one fcntl() per connection
+static long acceptOnePerWakeup(int listenFd, int clients, std::vector<int>& accepted) {
+    long wakeups = 0;
+    pollfd readable = {listenFd, POLLIN, 0};
+    while (static_cast<int>(accepted.size()) < clients) {
+        poll(&readable, 1, -1);
+        wakeups++;
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd != -1) {
+            fcntl(fd, F_SETFL, O_NONBLOCK);
+            accepted.push_back(fd);
+        }
+    }
+    return wakeups;
+}
+
+TEST_CASE("Reconnect storm: loop iterations until every client is accepted", "[.][benchmark][server]") {
+    const int clients = 2000;
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuseAddr = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof reuseAddr);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof address);
+    address.sin_family = AF_INET;
+    address.sin_port = htons(6681);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(bind(listenFd, reinterpret_cast<struct sockaddr*>(&address), sizeof address) == 0);
+    REQUIRE(listen(listenFd, SOMAXCONN) == 0);
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+    std::vector<int> peers = reconnectStorm("6681", clients);
+    std::vector<int> accepted;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    long oneWakeups = acceptOnePerWakeup(listenFd, clients, accepted);
+    double oneMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    closeAll(accepted);
+    closeAll(peers);
+    close(listenFd);
+
+    char port[] = "6680";
+    irc::Server server(port, "horse");
+    REQUIRE(server.start() == 0);
+    peers = reconnectStorm(port, clients);
+    long batchedIterations = 0;
+    start = std::chrono::steady_clock::now();
+    while (server.getClientCount() < static_cast<unsigned long>(clients)) {
+        server.loopOnce(1000);
+        batchedIterations++;
+    }
+    double batchedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    closeAll(peers);
+
+    std::cout << clients << " pending connections:" << std::endl
+              << "  accept per wakeup: " << oneWakeups << " loop iterations, " << oneMs << " ms" << std::endl
+              << "  batched accept4:   " << batchedIterations << " loop iterations, " << batchedMs << " ms" << std::endl;
+    REQUIRE(batchedIterations < oneWakeups);
+}
+
+static void stopServer(int signum) {
+    (void)signum;
+    isServerRunning_g = false;
+}
+
+/**
+ * Runs a server in a child process until SIGTERM. A traced child stops itself
+ * first, so the caller can attach to it as its tracer and count its system calls.
+ */
+static pid_t spawnServer(const char* port, irc::Poller::Backend backend, bool traced, int workers) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    int devNull = open("/dev/null", O_WRONLY);
+    dup2(devNull, STDOUT_FILENO);
+    dup2(devNull, STDERR_FILENO);
+    if (traced) {
+        ptrace(PTRACE_TRACEME, 0, NULL, NULL);
+        raise(SIGSTOP);
+    }
+    signal(SIGTERM, stopServer);
+    {
+        char serverPort[16];
+        strncpy(serverPort, port, sizeof serverPort - 1);
+        serverPort[sizeof serverPort - 1] = '\0';
+        irc::Server server(serverPort, "horse");
+        server.setEventBackend(backend);
+        server.setWorkerCount(workers);
+        if (server.start() == SUCCESS) {
+            server.loop();
+        }
+    }
+    _exit(0);
+}
+
+static int connectWhenListening(const char* port) {
+    for (int attempt = 0; attempt < 500; attempt++) {
+        int fd = connectTo(port);
+        if (fd != -1) {
+            return fd;
+        }
+        usleep(10000);
+    }
+    return -1;
+}
+
+static bool readLine(int fd, const std::string& needle) {
+    std::string received;
+    char buffer[4096];
+    while (received.find(needle) == std::string::npos) {
+        long long recv_ret = recv(fd, buffer, sizeof buffer, 0);
+        if (recv_ret <= 0) {
+            return false;
+        }
+        received.append(buffer, static_cast<unsigned long>(recv_ret));
+    }
+    return true;
+}
+
+static int registerClient(const char* port, const std::string& nick) {
+    int fd = connectWhenListening(port);
+    std::string registration = "PASS horse\r\nNICK " + nick + "\r\nUSER " + nick + " 0 * :B\r\n";
+    send(fd, registration.c_str(), registration.size(), 0);
+    readLine(fd, " 004 ");
+    return fd;
+}
+
+/**
+ * Each pair of clients relays PRIVMSGs from its sender to its receiver, a window of them at a time.
+ * The pairs are registered first, then the relaying starts once go is set and runs until stop is set.
+ * Returns the amount of messages the receivers got.
+ */
+static long relayPairs(const char* port, int firstPair, int pairs, int window, std::atomic<int>& registered, const std::atomic<bool>& go,
+                       const std::atomic<bool>& stop) {
+    std::vector<int> senders;
+    std::vector<int> receivers;
+    std::vector<std::string> bursts;
+    for (int i = firstPair; i < firstPair + pairs; i++) {
+        senders.push_back(registerClient(port, "send" + std::to_string(i)));
+        receivers.push_back(registerClient(port, "recv" + std::to_string(i)));
+        std::string burst;
+        for (int m = 0; m < window; m++) {
+            burst += "PRIVMSG recv" + std::to_string(i) + " :Hello, how is everyone doing today?\r\n";
+        }
+        bursts.push_back(burst);
+    }
+    registered++;
+    while (go == false) {
+        std::this_thread::yield();
+    }
+    long received = 0;
+    char buffer[65536];
+    bool isConnected = true;
+    while (stop == false && isConnected) {
+        for (unsigned long i = 0; i < senders.size(); i++) {
+            send(senders[i], bursts[i].c_str(), bursts[i].size(), 0);
+        }
+        for (unsigned long i = 0; i < receivers.size() && isConnected; i++) {
+            for (long lines = 0; lines < window;) {
+                long long recv_ret = recv(receivers[i], buffer, sizeof buffer, 0);
+                if (recv_ret <= 0) {
+                    isConnected = false;
+                    break;
+                }
+                lines += std::count(buffer, buffer + recv_ret, '\n');
+            }
+            received += window;
+        }
+    }
+    closeAll(senders);
+    closeAll(receivers);
+    return received;
+}
+
+TEST_CASE("PRIVMSG relay throughput per amount of workers", "[.][benchmark][server]") {
+    const int driverThreads = 4;
+    const int pairsPerThread = 8;
+    const int window = 32;
+    const int seconds = 3;
+    int workerCounts[] = {1, 2, 4};
+    const char* ports[] = {"6692", "6693", "6694"};
+
+    for (int w = 0; w < 3; w++) {
+        pid_t pid = spawnServer(ports[w], irc::Poller::BACKEND_EPOLL, false, workerCounts[w]);
+        std::atomic<int> registered(0);
+        std::atomic<bool> go(false);
+        std::atomic<bool> stop(false);
+        std::atomic<long> received(0);
+        std::vector<std::thread> drivers;
+        for (int t = 0; t < driverThreads; t++) {
+            drivers.push_back(std::thread(
+                [&, t]() { received += relayPairs(ports[w], t * pairsPerThread, pairsPerThread, window, registered, go, stop); }));
+        }
+        while (registered < driverThreads) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        go = true;
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        stop = true;
+        for (std::thread& driver : drivers) {
+            driver.join();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        kill(pid, SIGTERM);
+        waitpid(pid, NULL, 0);
+
+        REQUIRE(received > 0);
+        std::cout << "IRCSERV_WORKERS=" << workerCounts[w] << ": " << driverThreads * pairsPerThread << " client pairs, "
+                  << static_cast<double>(received) / elapsed << " messages/s" << std::endl;
+    }
+}
+
+/**
+ * Registered clients send one PING each per round and wait for all PONGs,
+ * the latency of every round trip is recorded while measuring is set.
+ */
+static void pingPong(const char* port, int clients, int rounds, std::vector<double>& latenciesUs, std::atomic<bool>& measuring) {
+    std::vector<int> fds;
+    for (int i = 0; i < clients; i++) {
+        fds.push_back(connectWhenListening(port));
+        std::string nick = "bench" + std::to_string(i);
+        std::string registration = "PASS horse\r\nNICK " + nick + "\r\nUSER " + nick + " 0 * :B\r\n";
+        send(fds.back(), registration.c_str(), registration.size(), 0);
+        readLine(fds.back(), " 004 ");
+    }
+    const int warmupRounds = 20;
+    std::string ping = "PING bench\r\n";
+    std::vector<std::chrono::steady_clock::time_point> sentAt(fds.size());
+    std::vector<pollfd> pollfds(fds.size());
+    char buffer[4096];
+    for (int round = 0; round < warmupRounds + rounds; round++) {
+        measuring = round >= warmupRounds;
+        for (unsigned long i = 0; i < fds.size(); i++) {
+            sentAt[i] = std::chrono::steady_clock::now();
+            send(fds[i], ping.c_str(), ping.size(), 0);
+            pollfds[i].fd = fds[i];
+            pollfds[i].events = POLLIN;
+        }
+        int pending = clients;
+        while (pending > 0 && poll(pollfds.data(), pollfds.size(), 5000) > 0) {
+            for (unsigned long i = 0; i < pollfds.size(); i++) {
+                if (pollfds[i].fd < 0 || pollfds[i].revents == 0) {
+                    continue;
+                }
+                recv(fds[i], buffer, sizeof buffer, 0);  // one PONG line
+                if (measuring) {
+                    latenciesUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sentAt[i]).count());
+                }
+                pollfds[i].fd = -1;
+                pending--;
+            }
+        }
+    }
+    measuring = false;
+    closeAll(fds);
+}
+
+// Counts the system calls of the stopped child until it exits, only while measuring is set
+static long traceSyscalls(pid_t pid, const std::atomic<bool>& measuring) {
+    int status;
+    waitpid(pid, &status, 0);
+    ptrace(PTRACE_SETOPTIONS, pid, NULL, PTRACE_O_TRACESYSGOOD | PTRACE_O_EXITKILL);
+    long syscalls = 0;
+    bool inSyscall = false;
+    int pendingSignal = 0;
+    while (ptrace(PTRACE_SYSCALL, pid, NULL, pendingSignal) == 0 && waitpid(pid, &status, 0) == pid) {
+        pendingSignal = 0;
+        if (WIFEXITED(status) || WIFSIGNALED(status)) {
+            break;
+        }
+        if (WSTOPSIG(status) != (SIGTRAP | 0x80)) {
+            pendingSignal = WSTOPSIG(status);
+            continue;
+        }
+        inSyscall = !inSyscall;  // stops alternate between entry and exit
+        if (inSyscall && measuring) {
+            syscalls++;
+        }
+    }
+    return syscalls;
+}
+
+static double percentile(std::vector<double>& samples, double fraction) {
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<unsigned long>(fraction * static_cast<double>(samples.size() - 1))];
+}
+
+TEST_CASE("Ping-pong round trips: system calls and latency per event backend", "[.][benchmark][server]") {
+    const int clients = 50;
+    const int rounds = 400;
+    const int tracedRounds = 50;
+    irc::Poller::Backend backends[] = {irc::Poller::BACKEND_POLL, irc::Poller::BACKEND_EPOLL, irc::Poller::BACKEND_URING};
+    const char* ports[][2] = {{"6686", "6687"}, {"6688", "6689"}, {"6690", "6691"}};
+    std::vector<double> syscallsPerRoundTrip;
+
+    for (int b = 0; b < 3; b++) {
+        std::unique_ptr<irc::Poller> probe = irc::Poller::create(backends[b]);
+        if (probe->getBackend() != backends[b]) {
+            std::cout << irc::Poller::getBackendName(backends[b]) << ": not available, skipped" << std::endl;
+            continue;
+        }
+        probe.reset();
+
+        // System calls, counted on a traced server
+        std::atomic<bool> measuring(false);
+        std::vector<double> ignored;
+        pid_t pid = spawnServer(ports[b][0], backends[b], true, 1);
+        std::thread tracedClients([&]() {
+            pingPong(ports[b][0], clients, tracedRounds, ignored, measuring);
+            kill(pid, SIGTERM);
+        });
+        long syscalls = traceSyscalls(pid, measuring);
+        tracedClients.join();
+        waitpid(pid, NULL, 0);
+
+        // Latency and CPU time, measured on an untraced server
+        std::vector<double> latenciesUs;
+        pid = spawnServer(ports[b][1], backends[b], false, 1);
+        pingPong(ports[b][1], clients, rounds, latenciesUs, measuring);
+        kill(pid, SIGTERM);
+        struct rusage usage;
+        wait4(pid, NULL, 0, &usage);
+        double cpuMs = static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+                       static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+
+        REQUIRE(latenciesUs.size() == static_cast<unsigned long>(clients * rounds));
+        syscallsPerRoundTrip.push_back(static_cast<double>(syscalls) / (clients * tracedRounds));
+        std::cout << irc::Poller::getBackendName(backends[b]) << ": " << clients << " clients, " << rounds << " rounds" << std::endl
+                  << "  server system calls per round trip: " << syscallsPerRoundTrip.back() << std::endl
+                  << "  latency p50 " << percentile(latenciesUs, 0.50) << " us, p99 " << percentile(latenciesUs, 0.99) << " us" << std::endl
+                  << "  server cpu time: " << cpuMs << " ms" << std::endl;
+    }
+    if (syscallsPerRoundTrip.size() == 3) {
+        REQUIRE(syscallsPerRoundTrip[2] < syscallsPerRoundTrip[1]);
+    }
+}
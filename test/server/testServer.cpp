@@ -1,7 +1,14 @@
 #include "../catch2/catch_amalgamated.hpp"
 
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <string>
+#include <thread>
+#include <vector>
 #include "../../src/common/magicNumber.h"
 #include "../../src/server/Server.h"
 
@@ -27,3 +34,230 @@ TEST_CASE("server is started properly", "[server]") {
     REQUIRE(server.getPort() == port);
     REQUIRE(errno == 0);
 }
+
+static int connectToServer(const char* port) {
+    struct addrinfo hints;
+    struct addrinfo* info;
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo("127.0.0.1", port, &hints, &info) != 0) {
+        return -1;
+    }
+    int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd != -1 && connect(fd, info->ai_addr, info->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(info);
+    return fd;
+}
+
+static std::string receiveAvailable(int fd) {
+    std::string received;
+    char buffer[4096];
+    long long recv_ret;
+    while ((recv_ret = recv(fd, buffer, sizeof buffer, MSG_DONTWAIT)) > 0) {
+        received.append(buffer, static_cast<unsigned long>(recv_ret));
+    }
+    return received;
+}
+
+TEST_CASE("server replies within the same loop iteration", "[server]") {
+    char port[] = "6678";
+    std::string password = "horse";
+    irc::Server server(port, password);
+    REQUIRE(server.start() == 0);
+
+    int clientFd = connectToServer(port);
+    REQUIRE(clientFd > 0);
+    server.loopOnce(1000);  // accept
+
+    std::string registration = "PASS horse\r\nNICK tester\r\nUSER tester 0 * :Tester\r\n";
+    REQUIRE(send(clientFd, registration.c_str(), registration.size(), 0) == static_cast<long>(registration.size()));
+    server.loopOnce(1000);  // receive, execute and flush the replies
+
+    std::string received = receiveAvailable(clientFd);
+    REQUIRE(received.find(" 001 tester :Welcome") != std::string::npos);
+    REQUIRE(received.find(" 004 tester ") != std::string::npos);
+
+    SECTION("an idle client does not wake up the server") {
+        std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+        server.loopOnce(100);
+        REQUIRE(std::chrono::steady_clock::now() - before >= std::chrono::milliseconds(90));
+    }
+
+    SECTION("a burst of messages is handled in one loop iteration") {
+        std::string burst;
+        for (int i = 0; i < 3000; i++) {
+            burst += "PING " + std::to_string(i) + "\r\n";
+        }
+        REQUIRE(send(clientFd, burst.c_str(), burst.size(), 0) == static_cast<long>(burst.size()));
+        usleep(50000);
+        server.loopOnce(1000);
+        usleep(10000);
+        std::string pongs = receiveAvailable(clientFd);
+        REQUIRE(pongs.size() == 3000 * std::string("PONG " + serverHostname_g + "\r\n").size());
+    }
+
+    SECTION("QUIT is answered and the client is disconnected") {
+        std::string quit = "QUIT :bye\r\n";
+        REQUIRE(send(clientFd, quit.c_str(), quit.size(), 0) == static_cast<long>(quit.size()));
+        server.loopOnce(1000);
+        usleep(10000);
+        REQUIRE(receiveAvailable(clientFd).find("ERROR :Quit: bye") != std::string::npos);
+        char byte;
+        REQUIRE(recv(clientFd, &byte, 1, MSG_DONTWAIT) == 0);  // orderly shutdown by the server
+    }
+    close(clientFd);
+}
+
+TEST_CASE("server accepts the whole listen backlog in one loop iteration", "[server]") {
+    char port[] = "6679";
+    std::string password = "horse";
+    irc::Server server(port, password);
+    REQUIRE(server.start() == 0);
+
+    std::vector<int> clientFds;
+    for (int i = 0; i < 100; i++) {
+        clientFds.push_back(connectToServer(port));
+        REQUIRE(clientFds.back() > 0);
+    }
+    server.loopOnce(1000);
+    REQUIRE(server.getClientCount() == 100);
+
+    SECTION("the accepted clients are served in the next iteration") {
+        std::string ping = "PING storm\r\n";
+        REQUIRE(send(clientFds.back(), ping.c_str(), ping.size(), 0) == static_cast<long>(ping.size()));
+        server.loopOnce(1000);
+        usleep(10000);
+        REQUIRE(receiveAvailable(clientFds.back()).find(" 451 ") != std::string::npos);  // not registered yet
+    }
+    for (int fd : clientFds) {
+        close(fd);
+    }
+}
+
+TEST_CASE("server handles every ready descriptor when clients disconnect", "[server]") {
+    char port[] = "6682";
+    std::string password = "horse";
+    irc::Server server(port, password);
+    REQUIRE(server.start() == 0);
+
+    std::vector<int> leavingFds;
+    std::vector<int> stayingFds;
+    for (int i = 0; i < 10; i++) {
+        leavingFds.push_back(connectToServer(port));
+        stayingFds.push_back(connectToServer(port));
+    }
+    server.loopOnce(1000);
+    REQUIRE(server.getClientCount() == 20);
+
+    // Reset the connections of half of the clients while the others send a message
+    struct linger abortive = {1, 0};
+    std::string ping = "PING churn\r\n";
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(setsockopt(leavingFds[i], SOL_SOCKET, SO_LINGER, &abortive, sizeof abortive) == 0);
+        close(leavingFds[i]);
+        REQUIRE(send(stayingFds[i], ping.c_str(), ping.size(), 0) == static_cast<long>(ping.size()));
+    }
+    usleep(50000);
+    server.loopOnce(1000);
+    REQUIRE(server.getClientCount() == 10);
+    usleep(10000);
+    for (int fd : stayingFds) {
+        REQUIRE(receiveAvailable(fd).find(" 451 ") != std::string::npos);
+        close(fd);
+    }
+}
+
+static std::string receiveUntil(int fd, const std::string& needle) {
+    std::string received;
+    for (int attempt = 0; attempt < 200 && received.find(needle) == std::string::npos; attempt++) {
+        usleep(10000);
+        received += receiveAvailable(fd);
+    }
+    return received;
+}
+
+// Stops the loop running in another thread, also when an assertion fails
+struct LoopThread {
+    irc::Server& server;
+    std::thread thread;
+    LoopThread(irc::Server& server) : server(server), thread(&irc::Server::loop, &server) {}
+    ~LoopThread() {
+        server.stop();
+        thread.join();
+    }
+};
+
+TEST_CASE("server with several workers serves clients of every reactor", "[server]") {
+    char port[] = "6683";
+    std::string password = "horse";
+    irc::Server server(port, password);
+    REQUIRE(server.setWorkerCount(0) == FAILURE);
+    REQUIRE(server.setWorkerCount(SERVER_MAX_WORKERS + 1) == FAILURE);
+    REQUIRE(server.setWorkerCount(2) == SUCCESS);
+    REQUIRE(server.getWorkerCount() == 2);
+    REQUIRE(server.start() == 0);
+    LoopThread loopThread(server);
+
+    std::vector<int> clientFds;
+    for (int i = 0; i < 8; i++) {
+        int fd = connectToServer(port);
+        REQUIRE(fd > 0);
+        std::string nick = "worker" + std::to_string(i);
+        std::string registration = "PASS horse\r\nNICK " + nick + "\r\nUSER " + nick + " 0 * :W\r\nJOIN #x\r\n";
+        REQUIRE(send(fd, registration.c_str(), registration.size(), 0) == static_cast<long>(registration.size()));
+        REQUIRE(receiveUntil(fd, " 353 ").find(" 353 ") != std::string::npos);
+        clientFds.push_back(fd);
+    }
+    REQUIRE(server.getClientCount() == 8);
+
+    std::string privmsg = "PRIVMSG #x :across reactors\r\n";
+    REQUIRE(send(clientFds[0], privmsg.c_str(), privmsg.size(), 0) == static_cast<long>(privmsg.size()));
+    for (unsigned long i = 1; i < clientFds.size(); i++) {
+        REQUIRE(receiveUntil(clientFds[i], "across reactors").find(":across reactors\r\n") != std::string::npos);
+    }
+
+    for (int fd : clientFds) {
+        close(fd);
+    }
+}
+
+TEST_CASE("server serves clients with the io_uring backend", "[server]") {
+    char port[] = "6684";
+    std::string password = "horse";
+    irc::Server server(port, password);
+    server.setEventBackend(irc::Poller::BACKEND_URING);
+    REQUIRE(server.start() == 0);
+    LoopThread loopThread(server);  // falls back to the default backend where io_uring is unavailable
+
+    int clientFd = connectToServer(port);
+    REQUIRE(clientFd > 0);
+    std::string registration = "PASS horse\r\nNICK tester\r\nUSER tester 0 * :Tester\r\n";
+    REQUIRE(send(clientFd, registration.c_str(), registration.size(), 0) == static_cast<long>(registration.size()));
+    REQUIRE(receiveUntil(clientFd, " 004 tester ").find(" 001 tester :Welcome") != std::string::npos);
+
+    std::string burst;
+    for (int i = 0; i < 3000; i++) {
+        burst += "PING " + std::to_string(i) + "\r\n";
+    }
+    REQUIRE(send(clientFd, burst.c_str(), burst.size(), 0) == static_cast<long>(burst.size()));
+    std::string pong = "PONG " + serverHostname_g + "\r\n";
+    std::string pongs;
+    for (int attempt = 0; attempt < 200 && pongs.size() < 3000 * pong.size(); attempt++) {
+        usleep(10000);
+        pongs += receiveAvailable(clientFd);
+    }
+    REQUIRE(pongs.size() == 3000 * pong.size());
+
+    std::string quit = "QUIT :bye\r\n";
+    REQUIRE(send(clientFd, quit.c_str(), quit.size(), 0) == static_cast<long>(quit.size()));
+    REQUIRE(receiveUntil(clientFd, "ERROR").find("ERROR :Quit: bye") != std::string::npos);
+    struct timeval timeout = {2, 0};
+    REQUIRE(setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout) == 0);
+    char byte;
+    REQUIRE(recv(clientFd, &byte, 1, 0) == 0);  // orderly shutdown by the server
+    close(clientFd);
+}